@@ -0,0 +1,482 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <spanstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <csvd/csvd.hpp>
+#include <csvd/query.hpp>
+
+#include "counters.hpp"
+#include "generators.hpp"
+
+namespace {
+
+    /**
+     * @brief The measurement of one benchmark
+     */
+    struct Result{
+        std::string benchmark{};  ///< What has been measured, e.g. `read`
+        std::string source{};     ///< Where the data came from, e.g. `file`
+        std::string dataset{};
+        size_t size = 0;        ///< The requested size of the dataset in bytes
+        size_t bytes = 0;       ///< Bytes processed per run
+        size_t rows = 0;        ///< Rows processed per run
+        size_t cells = 0;       ///< Cells processed per run
+        double seconds = 0;     ///< The fastest run, the median of the fastest runs of all repetitions
+        double mb_per_s_stddev = 0; ///< The standard deviation of the throughput between the repetitions
+        size_t runs = 0;
+        std::array<std::optional<double>, csvd::bench::event_count> events{}; ///< The mean hardware counts per run, if available
+    };
+
+    struct Options{
+        std::vector<size_t> sizes = {size_t(64) << 10, size_t(1) << 20, size_t(16) << 20};
+        double min_time = 0.25;         ///< Every benchmark is repeated for at least this many seconds
+        std::vector<std::string> filters;   ///< Only runs benchmarks whose name contains one of these strings
+        size_t repetitions = 1;         ///< Measures every benchmark this many times
+        std::string output;             ///< Writes the JSON into this file instead of stdout
+        std::string baseline;           ///< Compares the throughput with the results in this file
+        double tolerance = 0.1;         ///< The relative slowdown against the baseline that is still accepted
+        bool counters = true;           ///< Reads the hardware performance counters around the measured parts
+    };
+
+    /**
+     * @brief The counters that `timed` reads, `nullptr` if they are disabled
+     */
+    csvd::bench::Counters* counters = nullptr;
+
+    /**
+     * @brief Parses sizes like `64K`, `16M` or `1G`
+     */
+    size_t parse_size(std::string_view text){
+        size_t value = 0;
+        size_t i = 0;
+        for(; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i){
+            value = value * 10 + static_cast<size_t>(text[i] - '0');
+        }
+        if(i < text.size()){
+            switch(text[i]){
+                break; case 'K': case 'k': value <<= 10;
+                break; case 'M': case 'm': value <<= 20;
+                break; case 'G': case 'g': value <<= 30;
+                break; default: break;
+            }
+        }
+        return value;
+    }
+
+    std::string size_name(size_t bytes){
+        if(bytes >= (size_t(1) << 30) && bytes % (size_t(1) << 30) == 0) return std::to_string(bytes >> 30) + "G";
+        if(bytes >= (size_t(1) << 20) && bytes % (size_t(1) << 20) == 0) return std::to_string(bytes >> 20) + "M";
+        if(bytes >= (size_t(1) << 10) && bytes % (size_t(1) << 10) == 0) return std::to_string(bytes >> 10) + "K";
+        return std::to_string(bytes);
+    }
+
+    std::string name(const Result& result){
+        return result.benchmark + "/" + result.source + "/" + result.dataset + "/" + size_name(result.size);
+    }
+
+    /**
+     * @brief Repeats `run` for at least `min_time` seconds and returns the fastest run
+     *
+     * `run` returns the duration of the measured part, so the setup of every run is not included.
+     */
+    template<class Run>
+    std::pair<double, size_t> measure(double min_time, Run&& run){
+        double fastest = std::numeric_limits<double>::infinity();
+        double total = 0;
+        size_t runs = 0;
+        do{
+            const double seconds = run();
+            fastest = std::min(fastest, seconds);
+            total += seconds;
+            ++runs;
+        }while(total < min_time);
+        return {fastest, runs};
+    }
+
+    /**
+     * @brief Splits a comma separated list
+     */
+    std::vector<std::string_view> split(std::string_view text){
+        std::vector<std::string_view> parts;
+        for(size_t first = 0; first <= text.size();){
+            const size_t last = std::min(text.find(',', first), text.size());
+            parts.push_back(text.substr(first, last - first));
+            first = last + 1;
+        }
+        return parts;
+    }
+
+    template<class Function>
+    double timed(Function&& function){
+        if(counters != nullptr) counters->start();
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto stop = std::chrono::steady_clock::now();
+        if(counters != nullptr) counters->stop();
+        return std::chrono::duration<double>(stop - start).count();
+    }
+
+    void check(const tl::expected<void, csvd::ReadError>& result){
+        if(result.has_value() == false){
+            std::cerr << "csvd_bench: " << result.error() << std::endl;
+            std::exit(1);
+        }
+    }
+
+    void write_json(std::ostream& stream, const std::vector<Result>& results){
+        stream << "{\n  \"benchmarks\": [";
+        for(size_t i = 0; i < results.size(); ++i){
+            const Result& result = results[i];
+            const double megabytes = static_cast<double>(result.bytes) / 1e6;
+            stream << ((i == 0) ? "\n" : ",\n")
+                << "    {\"name\": \"" << name(result) << "\""
+                << ", \"benchmark\": \"" << result.benchmark << "\""
+                << ", \"source\": \"" << result.source << "\""
+                << ", \"dataset\": \"" << result.dataset << "\""
+                << ", \"size\": " << result.size
+                << ", \"bytes\": " << result.bytes
+                << ", \"rows\": " << result.rows
+                << ", \"cells\": " << result.cells
+                << ", \"runs\": " << result.runs
+                << ", \"seconds\": " << result.seconds
+                << ", \"mb_per_s\": " << megabytes / result.seconds
+                << ", \"mb_per_s_stddev\": " << result.mb_per_s_stddev
+                << ", \"rows_per_s\": " << static_cast<double>(result.rows) / result.seconds
+                << ", \"ns_per_cell\": " << ((result.cells != 0) ? result.seconds * 1e9 / static_cast<double>(result.cells) : 0.0);
+            for(size_t e = 0; e < result.events.size(); ++e){
+                if(result.events[e].has_value() == false){
+                    continue;
+                }
+                const std::string_view event = csvd::bench::event_name(static_cast<csvd::bench::Event>(e));
+                if(result.bytes != 0){
+                    stream << ", \"" << event << "_per_byte\": " << *result.events[e] / static_cast<double>(result.bytes);
+                }
+                if(result.cells != 0){
+                    stream << ", \"" << event << "_per_cell\": " << *result.events[e] / static_cast<double>(result.cells);
+                }
+            }
+            stream << "}";
+        }
+        stream << "\n  ]\n}\n";
+    }
+
+    class Bench{
+        public:
+            explicit Bench(Options options) : options_(std::move(options)) {
+                if(this->options_.counters){
+                    if(this->counters_.available()){
+                        counters = &this->counters_;
+                    }else{
+                        std::cerr << "csvd_bench: hardware counters are unavailable, check /proc/sys/kernel/perf_event_paranoid" << std::endl;
+                    }
+                }
+            }
+
+            ~Bench(){
+                counters = nullptr;
+            }
+
+            Bench(const Bench&) = delete;
+            Bench& operator=(const Bench&) = delete;
+
+            /**
+             * @brief Measures `run` if the name passes the filters
+             */
+            template<class Run>
+            void add(Result result, Run&& run){
+                const std::string result_name = name(result);
+                const bool selected = this->options_.filters.empty() || std::ranges::any_of(this->options_.filters, [&](const std::string& filter){
+                    return result_name.find(filter) != std::string::npos;
+                });
+                if(selected == false){
+                    return;
+                }
+                this->counters_.reset();
+                std::vector<double> samples;
+                size_t runs = 0;
+                for(size_t repetition = 0; repetition < std::max<size_t>(this->options_.repetitions, 1); ++repetition){
+                    const auto [fastest, repetition_runs] = measure(this->options_.min_time, run);
+                    samples.push_back(fastest);
+                    runs += repetition_runs;
+                }
+                std::ranges::sort(samples);
+                const double seconds = samples[samples.size() / 2];
+                result.seconds = seconds;
+                result.runs = runs;
+                result.mb_per_s_stddev = throughput_stddev(samples, result.bytes);
+                if(counters != nullptr){
+                    for(size_t e = 0; e < result.events.size(); ++e){
+                        if(this->counters_.available(static_cast<csvd::bench::Event>(e))){
+                            result.events[e] = this->counters_.total(static_cast<csvd::bench::Event>(e)) / static_cast<double>(runs);
+                        }
+                    }
+                }
+                std::cerr << name(result) << ": " << (static_cast<double>(result.bytes) / 1e6 / seconds) << " MB/s, "
+                    << (seconds * 1e9 / static_cast<double>(std::max<size_t>(result.cells, 1))) << " ns/cell";
+                const std::optional<double>& cycles = result.events[static_cast<size_t>(csvd::bench::Event::Cycles)];
+                if(cycles.has_value() && result.bytes != 0){
+                    std::cerr << ", " << (*cycles / static_cast<double>(result.bytes)) << " cycles/byte";
+                }
+                std::cerr << std::endl;
+                this->results_.push_back(std::move(result));
+            }
+
+            void run(const csvd::bench::Dataset& dataset, size_t size){
+                const std::string text = csvd::bench::generate(dataset, size);
+                const std::filesystem::path path = std::filesystem::temp_directory_path() / ("csvd_bench_" + dataset.name + ".csv");
+                std::ofstream(path, std::ios::binary) << text;
+
+                // the shape is taken from a first read, which also warms up the allocator
+                csvd::CSVd table;
+                {
+                    std::ispanstream stream(std::span<const char>(text.data(), text.size()));
+                    check(table.read(stream));
+                }
+                const size_t rows = table.empty() ? 0 : table[0].data.size();
+                const Result base{.dataset = dataset.name, .size = size, .bytes = text.size(), .rows = rows, .cells = rows * table.size()};
+
+                const auto read = [&](std::istream& stream){
+                    csvd::CSVd csv;
+                    const double seconds = timed([&]{check(csv.read(stream));});
+                    return seconds;
+                };
+                this->add(with(base, "read", "string"), [&]{
+                    std::istringstream stream(text);
+                    return read(stream);
+                });
+                this->add(with(base, "read", "span"), [&]{
+                    std::ispanstream stream(std::span<const char>(text.data(), text.size()));
+                    return read(stream);
+                });
+                this->add(with(base, "read", "file"), [&]{
+                    std::ifstream stream(path, std::ios::binary);
+                    return read(stream);
+                });
+
+                this->add(with(base, "write", "string"), [&]{
+                    std::ostringstream stream;
+                    return timed([&]{table.write(stream);});
+                });
+
+                this->add(with(base, "find_first_row", "span"), [&]{
+                    std::ispanstream stream(std::span<const char>(text.data(), text.size()));
+                    // never true, scans the whole file
+                    return timed([&]{
+                        const auto found = csvd::find_first_row(stream, csvd::isnan(csvd::col("Column 0")));
+                        if(found.has_value() == false || found->has_value()){
+                            std::exit(1);
+                        }
+                    });
+                });
+
+                // looks up every column by name
+                std::vector<std::string> names;
+                for(const csvd::Column& column : table){
+                    names.push_back(column.name);
+                }
+                Result lookup = with(base, "find", "table");
+                lookup.bytes = 0;
+                lookup.rows = names.size();
+                lookup.cells = names.size();
+                this->add(lookup, [&]{
+                    size_t found = 0;
+                    const double seconds = timed([&]{
+                        for(const std::string& column : names){
+                            found += (table.find(column) != table.end()) ? 1 : 0;
+                        }
+                    });
+                    if(found != names.size()){
+                        std::exit(1);
+                    }
+                    return seconds;
+                });
+
+                std::filesystem::remove(path);
+            }
+
+            [[nodiscard]] const std::vector<Result>& results() const {return this->results_;}
+
+        private:
+            static double throughput_stddev(const std::vector<double>& samples, size_t bytes){
+                if(samples.size() < 2){
+                    return 0;
+                }
+                double sum = 0;
+                for(const double seconds : samples) sum += static_cast<double>(bytes) / 1e6 / seconds;
+                const double mean = sum / static_cast<double>(samples.size());
+                double squares = 0;
+                for(const double seconds : samples){
+                    const double deviation = static_cast<double>(bytes) / 1e6 / seconds - mean;
+                    squares += deviation * deviation;
+                }
+                return std::sqrt(squares / static_cast<double>(samples.size() - 1));
+            }
+
+            static Result with(Result result, std::string benchmark, std::string source){
+                result.benchmark = std::move(benchmark);
+                result.source = std::move(source);
+                return result;
+            }
+
+            Options options_;
+            csvd::bench::Counters counters_;
+            std::vector<Result> results_;
+    };
+
+    /**
+     * @brief The throughput of a benchmark in a baseline file
+     */
+    struct Reference{
+        std::string name;
+        double mb_per_s = 0;
+        double mb_per_s_stddev = 0;
+    };
+
+    /**
+     * @brief Reads the results of a JSON file that has been written by `write_json`, one benchmark per line
+     */
+    std::vector<Reference> read_baseline(const std::string& path){
+        std::vector<Reference> references;
+        std::ifstream file(path);
+        std::string line;
+        const auto number = [&](std::string_view key){
+            const size_t position = line.find(key);
+            return (position == std::string::npos) ? 0.0 : std::strtod(line.c_str() + position + key.size(), nullptr);
+        };
+        while(std::getline(file, line)){
+            constexpr std::string_view key = "{\"name\": \"";
+            const size_t first = line.find(key);
+            if(first == std::string::npos){
+                continue;
+            }
+            const size_t last = line.find('"', first + key.size());
+            references.push_back(Reference{
+                .name = line.substr(first + key.size(), last - first - key.size()),
+                .mb_per_s = number("\"mb_per_s\": "),
+                .mb_per_s_stddev = number("\"mb_per_s_stddev\": "),
+            });
+        }
+        return references;
+    }
+
+    /**
+     * @brief Compares the throughput of `read` and `write` with the baseline and returns `false` on regressions
+     *
+     * A benchmark regresses if it is slower than the baseline by more than the tolerance and if the
+     * difference is larger than twice the combined standard deviation of both measurements, so noise
+     * between the repetitions does not fail the check.
+     */
+    bool compare(const std::vector<Result>& results, const std::vector<Reference>& baseline, double tolerance){
+        bool passed = true;
+        for(const Result& result : results){
+            if(result.benchmark != "read" && result.benchmark != "write"){
+                continue;
+            }
+            const std::string result_name = name(result);
+            const auto reference = std::ranges::find(baseline, result_name, &Reference::name);
+            if(reference == baseline.end()){
+                std::cerr << result_name << ": not in the baseline" << std::endl;
+                continue;
+            }
+            const double mb_per_s = static_cast<double>(result.bytes) / 1e6 / result.seconds;
+            const double noise = 2 * std::hypot(result.mb_per_s_stddev, reference->mb_per_s_stddev);
+            const double difference = reference->mb_per_s - mb_per_s;
+            const bool regressed = (mb_per_s < reference->mb_per_s * (1 - tolerance)) && (difference > noise);
+            std::cerr << result_name << ": " << mb_per_s << " MB/s, baseline " << reference->mb_per_s << " MB/s ("
+                << ((mb_per_s / reference->mb_per_s - 1) * 100) << "%)" << (regressed ? " REGRESSION" : "") << std::endl;
+            passed = passed && (regressed == false);
+        }
+        return passed;
+    }
+
+    void print_usage(){
+        std::cerr <<
+            "usage: csvd_bench [options]\n"
+            "  --sizes 64K,1M,16M   sizes of the generated datasets, K, M and G are powers of 1024\n"
+            "  --min-time 0.25      minimum time per benchmark in seconds, the fastest run is reported\n"
+            "  --filter read/file   only runs benchmarks whose name contains one of the comma separated strings\n"
+            "  --repetitions 1      measures every benchmark this many times and reports the median\n"
+            "  --output bench.json  writes the JSON results into the file instead of stdout\n"
+            "  --baseline base.json fails if read or write are significantly slower than in the results of the file\n"
+            "  --tolerance 0.1      the relative slowdown against the baseline that is accepted\n"
+            "  --counters on        reads the hardware performance counters (Linux), on or off\n";
+    }
+
+}// namespace
+
+int main(int argc, char* argv[]){
+    Options options;
+    for(int i = 1; i < argc; ++i){
+        const std::string_view argument = argv[i];
+        if(i + 1 >= argc){
+            print_usage();
+            return 1;
+        }
+        const std::string_view value = argv[++i];
+        if(argument == "--sizes"){
+            options.sizes.clear();
+            for(const std::string_view size : split(value)){
+                options.sizes.push_back(parse_size(size));
+            }
+        }else if(argument == "--min-time"){
+            options.min_time = std::stod(std::string(value));
+        }else if(argument == "--filter"){
+            for(const std::string_view filter : split(value)){
+                options.filters.emplace_back(filter);
+            }
+        }else if(argument == "--repetitions"){
+            options.repetitions = std::stoul(std::string(value));
+        }else if(argument == "--baseline"){
+            options.baseline = value;
+        }else if(argument == "--tolerance"){
+            options.tolerance = std::stod(std::string(value));
+        }else if(argument == "--output"){
+            options.output = value;
+        }else if(argument == "--counters"){
+            options.counters = (value != "off");
+        }else{
+            print_usage();
+            return 1;
+        }
+    }
+
+    Bench bench(options);
+    for(const size_t size : options.sizes){
+        for(const csvd::bench::Dataset& dataset : csvd::bench::default_datasets()){
+            bench.run(dataset, size);
+        }
+    }
+
+    if(options.output.empty()){
+        write_json(std::cout, bench.results());
+    }else{
+        std::ofstream file(options.output);
+        write_json(file, bench.results());
+    }
+
+    if(options.baseline.empty() == false){
+        const std::vector<Reference> baseline = read_baseline(options.baseline);
+        if(baseline.empty()){
+            std::cerr << "csvd_bench: no results in the baseline " << options.baseline << std::endl;
+            return 1;
+        }
+        if(compare(bench.results(), baseline, options.tolerance) == false){
+            std::cerr << "csvd_bench: performance regression against " << options.baseline << std::endl;
+            return 2;
+        }
+    }
+    return 0;
+}
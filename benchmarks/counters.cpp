@@ -0,0 +1,145 @@
+#include "counters.hpp"
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace csvd::bench{
+
+    std::string_view event_name(Event event){
+        switch(event){
+            break; case Event::Cycles: return "cycles";
+            break; case Event::Instructions: return "instructions";
+            break; case Event::BranchMisses: return "branch_misses";
+            break; case Event::L1DMisses: return "l1d_misses";
+            break; case Event::LLCMisses: return "llc_misses";
+            break; case Event::DTLBMisses: return "dtlb_misses";
+        }
+        return "unknown";
+    }
+
+#if defined(__linux__)
+
+    namespace {
+
+        /**
+         * @brief The value of a counter that has been opened with `PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING`
+         */
+        struct Reading{
+            std::uint64_t value;
+            std::uint64_t enabled;
+            std::uint64_t running;
+        };
+
+        constexpr std::uint64_t cache_read_miss(std::uint64_t cache){
+            return cache | (std::uint64_t(PERF_COUNT_HW_CACHE_OP_READ) << 8) | (std::uint64_t(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+        }
+
+        int open_event(Event event){
+            perf_event_attr attributes{};
+            attributes.size = sizeof(attributes);
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            switch(event){
+                break; case Event::Cycles:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+                break; case Event::Instructions:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break; case Event::BranchMisses:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break; case Event::L1DMisses:
+                    attributes.type = PERF_TYPE_HW_CACHE;
+                    attributes.config = cache_read_miss(PERF_COUNT_HW_CACHE_L1D);
+                break; case Event::LLCMisses:
+                    attributes.type = PERF_TYPE_HW_CACHE;
+                    attributes.config = cache_read_miss(PERF_COUNT_HW_CACHE_LL);
+                break; case Event::DTLBMisses:
+                    attributes.type = PERF_TYPE_HW_CACHE;
+                    attributes.config = cache_read_miss(PERF_COUNT_HW_CACHE_DTLB);
+            }
+            // the calling thread on any CPU
+            return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        }
+
+    }// namespace
+
+    Counters::Counters(){
+        for(size_t i = 0; i < event_count; ++i){
+            this->files_[i] = open_event(static_cast<Event>(i));
+        }
+    }
+
+    Counters::~Counters(){
+        for(const int file : this->files_){
+            if(file >= 0){
+                close(file);
+            }
+        }
+    }
+
+    void Counters::start(){
+        for(const int file : this->files_){
+            if(file >= 0){
+                ioctl(file, PERF_EVENT_IOC_RESET, 0);
+                ioctl(file, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void Counters::stop(){
+        for(size_t i = 0; i < event_count; ++i){
+            if(this->files_[i] < 0){
+                continue;
+            }
+            ioctl(this->files_[i], PERF_EVENT_IOC_DISABLE, 0);
+            Reading reading{};
+            if(read(this->files_[i], &reading, sizeof(reading)) == static_cast<ssize_t>(sizeof(reading)) && reading.running != 0){
+                this->totals_[i] += static_cast<double>(reading.value) * static_cast<double>(reading.enabled) / static_cast<double>(reading.running);
+            }
+        }
+    }
+
+#else
+
+    Counters::Counters(){
+        this->files_.fill(-1);
+    }
+
+    Counters::~Counters() = default;
+
+    void Counters::start(){}
+
+    void Counters::stop(){}
+
+#endif
+
+    bool Counters::available() const {
+        for(const int file : this->files_){
+            if(file >= 0){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Counters::available(Event event) const {
+        return this->files_[static_cast<size_t>(event)] >= 0;
+    }
+
+    void Counters::reset(){
+        this->totals_.fill(0);
+    }
+
+    double Counters::total(Event event) const {
+        return this->totals_[static_cast<size_t>(event)];
+    }
+
+}// namespace csvd::bench
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace csvd::bench{
+
+    /**
+     * @brief The hardware events that are counted around the benchmarks
+     */
+    enum class Event{
+        Cycles,
+        Instructions,
+        BranchMisses,
+        L1DMisses,      ///< Misses of the level 1 data cache on reads
+        LLCMisses,      ///< Misses of the last level cache on reads
+        DTLBMisses,     ///< Misses of the data TLB on reads
+    };
+
+    inline constexpr size_t event_count = 6;
+
+    /**
+     * @brief Returns the name of the event as it is written into the results, e.g. `branch_misses`
+     */
+    [[nodiscard]] std::string_view event_name(Event event);
+
+    /**
+     * @brief Reads the Linux `perf_event_open` counters of the calling thread
+     *
+     * Every event is opened on its own, so the events that the CPU, the kernel or a container do not
+     * allow are skipped while the others are still counted. Counts of multiplexed events are scaled to
+     * the time they were enabled. On other systems no event is available.
+     */
+    class Counters{
+        public:
+            Counters();
+            ~Counters();
+
+            Counters(const Counters&) = delete;
+            Counters& operator=(const Counters&) = delete;
+
+            /**
+             * @brief Returns `true` if at least one event can be counted
+             */
+            [[nodiscard]] bool available() const;
+
+            /**
+             * @brief Returns `true` if the event can be counted
+             */
+            [[nodiscard]] bool available(Event event) const;
+
+            /**
+             * @brief Sets the accumulated counts to zero
+             */
+            void reset();
+
+            /**
+             * @brief Starts counting, the counts between `start` and `stop` are added to the totals
+             */
+            void start();
+
+            void stop();
+
+            /**
+             * @brief Returns the accumulated count of the event since the last `reset`
+             */
+            [[nodiscard]] double total(Event event) const;
+
+        private:
+            std::array<int, event_count> files_;
+            std::array<double, event_count> totals_{};
+    };
+
+}// namespace csvd::bench
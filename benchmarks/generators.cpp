@@ -0,0 +1,98 @@
+#include <array>
+#include <charconv>
+#include <cmath>
+
+#include "generators.hpp"
+
+namespace csvd::bench{
+
+    namespace {
+
+        /**
+         * @brief Small deterministic pseudo random number generator (splitmix64)
+         */
+        class Random{
+            public:
+                explicit Random(std::uint64_t seed) : state_(seed) {}
+
+                std::uint64_t next(){
+                    std::uint64_t z = (this->state_ += 0x9E3779B97F4A7C15ull);
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                    return z ^ (z >> 31);
+                }
+
+                /// Uniform in `[0, 1)`
+                double uniform(){
+                    return static_cast<double>(this->next() >> 11) * 0x1.0p-53;
+                }
+
+            private:
+                std::uint64_t state_;
+        };
+
+        void append_number(std::string& text, Random& random, Numbers numbers){
+            std::array<char, 32> characters;
+            std::to_chars_result result;
+            switch(numbers){
+                case Numbers::Short:{
+                    // one decimal digit and up to three integer digits
+                    const double value = static_cast<double>(random.next() % 10'000) / 10.0;
+                    result = std::to_chars(characters.data(), characters.data() + characters.size(), value, std::chars_format::fixed, 1);
+                }break;
+                case Numbers::Long:{
+                    const double mantissa = random.uniform() * 2.0 - 1.0;
+                    const int exponent = static_cast<int>(random.next() % 41) - 20;
+                    result = std::to_chars(characters.data(), characters.data() + characters.size(), mantissa * std::pow(10.0, exponent), std::chars_format::scientific, 16);
+                }break;
+            }
+            text.append(characters.data(), result.ptr);
+        }
+
+    }// namespace
+
+    std::vector<Dataset> default_datasets(){
+        return {
+            Dataset{"narrow_short", 3, Numbers::Short, false, ','},
+            Dataset{"narrow_long", 3, Numbers::Long, false, ','},
+            Dataset{"wide_short", 64, Numbers::Short, false, ','},
+            Dataset{"wide_long", 64, Numbers::Long, false, ','},
+            Dataset{"quoted_semicolon", 8, Numbers::Short, true, ';'},
+            Dataset{"tab", 8, Numbers::Long, false, '\t'},
+        };
+    }
+
+    std::string generate(const Dataset& dataset, size_t bytes){
+        std::string text;
+        text.reserve(bytes + 1024);
+        for(size_t c = 0; c < dataset.columns; ++c){
+            if(c != 0){
+                text.push_back(dataset.separator);
+            }
+            if(dataset.quoted_header) text.push_back('"');
+            text.append("Column ");
+            text.append(std::to_string(c));
+            if(dataset.quoted_header) text.push_back('"');
+        }
+        text.push_back('\n');
+
+        Random random(0xC5Dull + dataset.columns);
+        std::string row;
+        while(true){
+            row.clear();
+            for(size_t c = 0; c < dataset.columns; ++c){
+                if(c != 0){
+                    row.push_back(dataset.separator);
+                }
+                append_number(row, random, dataset.numbers);
+            }
+            row.push_back('\n');
+            if(text.size() + row.size() > bytes){
+                break;
+            }
+            text.append(row);
+        }
+        return text;
+    }
+
+}// namespace csvd::bench
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace csvd::bench{
+
+    /**
+     * @brief How the numbers of a generated dataset look
+     */
+    enum class Numbers{
+        Short,  ///< Small numbers with few digits, e.g. `12.5`
+        Long,   ///< Numbers with all 17 significant digits and exponents, e.g. `-1.2345678901234567e-05`
+    };
+
+    /**
+     * @brief Describes the shape of a synthetic CSV file
+     */
+    struct Dataset{
+        std::string name;
+        size_t columns = 1;
+        Numbers numbers = Numbers::Short;
+        bool quoted_header = false;     ///< Writes the column names in double quotes
+        char separator = ',';           ///< The value separator
+    };
+
+    /**
+     * @brief Returns the datasets that are benchmarked by default: narrow and wide, short and long numbers, quoted headers and all separators
+     */
+    [[nodiscard]] std::vector<Dataset> default_datasets();
+
+    /**
+     * @brief Generates a CSV file with a header and as many whole rows as fit into about `bytes` bytes
+     *
+     * The content only depends on the dataset and the size, every run produces the same bytes.
+     */
+    [[nodiscard]] std::string generate(const Dataset& dataset, size_t bytes);
+
+}// namespace csvd::bench
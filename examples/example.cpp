@@ -61,10 +61,10 @@ int main(int argc, char* argv[]){
             std::cout << "  column name: " << column->name << std::endl;
             std::cout << "  column size: " << column->data.size() << std::endl;
             std::cout << "  first 3 values: ";
-        }
 
-        std::cout << "Erase column 'Frequencies (Hz)'" << std::endl;
-        csv.erase(column);
+            std::cout << "Erase column 'Frequencies (Hz)'" << std::endl;
+            csv.erase(column);
+        }
     }
     {
         auto column = csv.find("Home Prices");
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief The value and the row index of a minimum or maximum
+     */
+    struct Extremum{
+        double value = std::numeric_limits<double>::quiet_NaN();    ///< The extreme value. NaN if there is none.
+        size_t index = std::numeric_limits<size_t>::max();          ///< The row of the first occurrence. `size_t(-1)` if there is none.
+    };
+
+    /**
+     * @brief Returns the sum of all values in the column
+     * 
+     * Uses compensated (Kahan-Babuska) summation on independent lanes, so the result is accurate
+     * even for long columns with values of very different magnitude.
+     * 
+     * @param column The column to sum up
+     * @param parallel Controls the multi-threading of large columns
+     * @return The sum, `0` for an empty column
+     */
+    [[nodiscard]] double sum(const Column& column, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Returns the arithmetic mean of the column, NaN if empty
+     */
+    [[nodiscard]] double mean(const Column& column, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Returns the smallest value and its first row index
+     * 
+     * NaN values are ignored.
+     */
+    [[nodiscard]] Extremum minimum(const Column& column, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Returns the largest value and its first row index
+     * 
+     * NaN values are ignored.
+     */
+    [[nodiscard]] Extremum maximum(const Column& column, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Returns the dot product of two columns
+     * 
+     * If the columns differ in length only the common rows are used.
+     */
+    [[nodiscard]] double dot(const Column& a, const Column& b, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Returns the euclidean (L2) norm of the column
+     */
+    [[nodiscard]] double norm(const Column& column, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Returns the population variance of the column, NaN if empty
+     */
+    [[nodiscard]] double variance(const Column& column, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Computes count, min, max, mean and variance in a single pass over the column
+     * 
+     * Does the same as `Column::enable_statistics()` but vectorized and multi-threaded.
+     */
+    [[nodiscard]] Statistics statistics(const Column& column, const ParallelSettings& parallel = ParallelSettings());
+
+}// namespace csvd
@@ -1,22 +1,305 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <deque>
+#include <initializer_list>
 #include <array>
+#include <vector>
 #include <string>
 #include <optional>
+#include <functional>
+#include <stop_token>
 #include <ostream>
 #include <istream>
+#include <limits>
+#include <cmath>
 
 #include <tl/expected.hpp>
 
 namespace csvd{
+
+    /**
+     * @brief Running statistics over a series of values
+     * 
+     * Values are accumulated in a single pass. Mean and variance are updated with
+     * Welford's algorithm, which stays numerically stable for long series.
+     * NaN values propagate into the mean and variance but are ignored by `min` and `max`.
+     */
+    struct Statistics{
+        size_t count = 0;                                       ///< Number of accumulated values
+        double min = std::numeric_limits<double>::infinity();   ///< Smallest value, `+inf` if empty
+        double max = -std::numeric_limits<double>::infinity();  ///< Largest value, `-inf` if empty
+        double mean = 0;                                        ///< Arithmetic mean, `0` if empty
+        double m2 = 0;                                          ///< Sum of squared differences from the mean
+
+        /**
+         * @brief Accumulates a new value
+         */
+        inline void push(double value){
+            ++this->count;
+            const double delta = value - this->mean;
+            this->mean += delta / static_cast<double>(this->count);
+            this->m2 += delta * (value - this->mean);
+            if(value < this->min) this->min = value;
+            if(value > this->max) this->max = value;
+        }
+
+        /**
+         * @brief Combines the statistics of two disjoint series (Chan et al.)
+         */
+        inline void merge(const Statistics& other){
+            if(other.count == 0) return;
+            if(this->count == 0){
+                *this = other;
+                return;
+            }
+            const double n_a = static_cast<double>(this->count);
+            const double n_b = static_cast<double>(other.count);
+            const double n = n_a + n_b;
+            const double delta = other.mean - this->mean;
+            this->mean += delta * (n_b / n);
+            this->m2 += other.m2 + delta * delta * (n_a * n_b / n);
+            this->count += other.count;
+            if(other.min < this->min) this->min = other.min;
+            if(other.max > this->max) this->max = other.max;
+        }
+
+        /**
+         * @brief Population variance, NaN if empty
+         */
+        [[nodiscard]] inline double variance() const {
+            return (this->count > 0) ? this->m2 / static_cast<double>(this->count) : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        /**
+         * @brief Sample variance (Bessel corrected), NaN if there are less than two values
+         */
+        [[nodiscard]] inline double sample_variance() const {
+            return (this->count > 1) ? this->m2 / static_cast<double>(this->count - 1) : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        /**
+         * @brief Population standard deviation, NaN if empty
+         */
+        [[nodiscard]] inline double stddev() const {return std::sqrt(this->variance());}
+    };
     
+    /**
+     * @brief The order of the values in a column
+     */
+    enum class Sortedness{
+        Constant,   ///< All values are equal, also for empty columns. Sorted in both directions.
+        Ascending,  ///< Every value is greater than or equal to its predecessor
+        Descending, ///< Every value is less than or equal to its predecessor
+        Unsorted,   ///< Neither ascending nor descending, or contains NaN
+    };
+
+    /**
+     * @brief Returns the sortedness of a column after `value` has been appended behind `previous`
+     */
+    [[nodiscard]] constexpr Sortedness next_sortedness(Sortedness sortedness, double previous, double value){
+        if(value > previous){
+            return (sortedness == Sortedness::Constant || sortedness == Sortedness::Ascending) ? Sortedness::Ascending : Sortedness::Unsorted;
+        }else if(value < previous){
+            return (sortedness == Sortedness::Constant || sortedness == Sortedness::Descending) ? Sortedness::Descending : Sortedness::Unsorted;
+        }else if(value == previous){
+            return sortedness;
+        }
+        return Sortedness::Unsorted; // NaN
+    }
+
+    /// Number of rows that are summarized by one `Zone`
+    inline constexpr size_t zone_size = 4096;
+
+    /**
+     * @brief The range of the values in one block of `zone_size` rows of a column (a zone map entry)
+     *
+     * Filters and range queries test the zones first and skip blocks that cannot contain a
+     * matching row, or select them as a whole without reading their values. On locally clustered
+     * data, e.g. slowly drifting sensor readings, this only touches a small fraction of the column.
+     */
+    struct Zone{
+        double min = std::numeric_limits<double>::infinity();   ///< Smallest value that is not NaN, `+inf` if there is none
+        double max = -std::numeric_limits<double>::infinity();  ///< Largest value that is not NaN, `-inf` if there is none
+        bool has_nan = false;                                   ///< `true` if the block contains NaN
+
+        inline void push(double value){
+            if(value < this->min) this->min = value;
+            if(value > this->max) this->max = value;
+            if(value != value) this->has_nan = true;
+        }
+    };
+
+    /**
+     * @brief The values of a column, a read only `std::deque<double>`
+     *
+     * The values are modified through `Column::values()`, so the column knows when its
+     * `sortedness` and `zones` no longer describe them.
+     */
+    class ColumnData{
+    public:
+        using value_type = double;
+        using size_type = std::deque<double>::size_type;
+        using difference_type = std::deque<double>::difference_type;
+        using reference = const double&;
+        using const_reference = const double&;
+        using iterator = std::deque<double>::const_iterator;
+        using const_iterator = std::deque<double>::const_iterator;
+        using reverse_iterator = std::deque<double>::const_reverse_iterator;
+        using const_reverse_iterator = std::deque<double>::const_reverse_iterator;
+
+        ColumnData() = default;
+        ColumnData(std::initializer_list<double> values) : values_(values){}
+        ColumnData(std::deque<double> values) : values_(std::move(values)){}
+        ColumnData(const ColumnData&) = default;
+        ColumnData(ColumnData&&) noexcept = default;
+
+        [[nodiscard]] inline size_type size() const {return this->values_.size();}
+        [[nodiscard]] inline bool empty() const {return this->values_.empty();}
+        [[nodiscard]] inline const double& operator[](size_type i) const {return this->values_[i];}
+        [[nodiscard]] inline const double& at(size_type i) const {return this->values_.at(i);}
+        [[nodiscard]] inline const double& front() const {return this->values_.front();}
+        [[nodiscard]] inline const double& back() const {return this->values_.back();}
+        [[nodiscard]] inline const_iterator begin() const {return this->values_.begin();}
+        [[nodiscard]] inline const_iterator end() const {return this->values_.end();}
+        [[nodiscard]] inline const_iterator cbegin() const {return this->values_.cbegin();}
+        [[nodiscard]] inline const_iterator cend() const {return this->values_.cend();}
+        [[nodiscard]] inline const_reverse_iterator rbegin() const {return this->values_.rbegin();}
+        [[nodiscard]] inline const_reverse_iterator rend() const {return this->values_.rend();}
+
+        inline operator const std::deque<double>&() const {return this->values_;}
+
+        friend bool operator==(const ColumnData&, const ColumnData&) = default;
+
+    private:
+        friend struct Column;
+
+        // only the column replaces its values, see `Column::values()`
+        ColumnData& operator=(const ColumnData&) = default;
+        ColumnData& operator=(ColumnData&&) noexcept = default;
+
+        std::deque<double> values_;
+    };
+
     /**
      * @brief Represenst a column of a csv file with a name and data vector
+     * 
+     * Values appended through `push_back`, `emplace_back` and `append` keep the optional
+     * running `statistics`, the `sortedness` and the `zones` up to date. Modifications through `values()` do not,
+     * call `enable_statistics()`, `update_sortedness()` and `update_zones()` afterwards to recompute them.
      */
     struct Column{
         std::string name; ///< The name used in the header of the csv file. Empty if there is no header.
-        std::deque<double> data; ///< The data vector that correlates to the header name
+        ColumnData data; ///< The data vector that correlates to the header name, modified through `values()`
+        std::optional<Statistics> statistics{}; ///< Running statistics over `data`. Only maintained if engaged.
+        Sortedness sortedness = Sortedness::Constant; ///< The order of the first `sorted_rows` values of `data`, maintained on every append
+        size_t sorted_rows = 0; ///< The number of values that `sortedness` describes, see `has_sortedness`
+        std::vector<Zone> zones{}; ///< The range of every `zone_size` rows of `data`, maintained on every append
+
+        /**
+         * @brief Appends a value and updates the running statistics
+         */
+        inline void push_back(double value){
+            if(this->has_sortedness() == false){
+                // `data` has been modified directly
+                this->update_sortedness();
+            }
+            if(this->sortedness != Sortedness::Unsorted && this->data.empty() == false){
+                this->sortedness = next_sortedness(this->sortedness, this->data.back(), value);
+            }
+            ++this->sorted_rows;
+            if(this->has_zones() == false){
+                this->update_zones();
+            }
+            if(this->data.size() % zone_size == 0){
+                this->zones.emplace_back();
+            }
+            this->zones.back().push(value);
+            this->data.values_.push_back(value);
+            if(this->statistics.has_value()){
+                this->statistics->push(value);
+            }
+        }
+
+        /**
+         * @brief Appends a value and updates the running statistics
+         */
+        inline const double& emplace_back(double value){
+            this->push_back(value);
+            return this->data.back();
+        }
+
+        /**
+         * @brief Appends a range of values and updates the running statistics
+         */
+        template<class InputIt>
+        void append(InputIt first, InputIt last){
+            for(; first != last; ++first){
+                this->push_back(*first);
+            }
+        }
+
+        /**
+         * @brief Returns the values for direct modifications
+         *
+         * The `sortedness` and the `zones` are reset to those of an empty column, so algorithms no longer
+         * rely on them until `update_sortedness()` and `update_zones()` are called. The reference must not
+         * be used after other member functions of the column have been called.
+         */
+        inline std::deque<double>& values(){
+            this->sortedness = Sortedness::Constant;
+            this->sorted_rows = 0;
+            this->zones.clear();
+            return this->data.values_;
+        }
+
+        /**
+         * @brief Computes the statistics over the current data and keeps them updated on future appends
+         */
+        void enable_statistics();
+
+        /**
+         * @brief Stops maintaining the running statistics
+         */
+        inline void disable_statistics(){this->statistics.reset();}
+
+        /**
+         * @brief Recomputes the `sortedness` after modifications through `values()`
+         */
+        void update_sortedness();
+
+        /**
+         * @brief Returns `true` if `sortedness` describes all values of `data`
+         *
+         * Values that have been modified through `values()` or initialized directly are not covered, e.g. `Column{"Time", {5.0, 1.0, 3.0}}`.
+         */
+        [[nodiscard]] inline bool has_sortedness() const {return this->sorted_rows == this->data.size();}
+
+        /**
+         * @brief Returns the `sortedness` if it is up to date, otherwise the order is determined from `data`
+         */
+        [[nodiscard]] Sortedness order() const;
+
+        /**
+         * @brief Rebuilds the `zones` after modifications through `values()`
+         */
+        void update_zones();
+
+        /**
+         * @brief Returns `true` if there is one zone for every started block of `zone_size` rows
+         *
+         * `values()` drops the zones, algorithms fall back to reading all values if the zones do not match the size of `data`.
+         */
+        [[nodiscard]] inline bool has_zones() const {
+            return this->zones.size() == (this->data.size() + zone_size - 1) / zone_size;
+        }
+
+        /**
+         * @brief Returns an empty column with the same name that maintains the same running information
+         */
+        [[nodiscard]] Column clone_empty() const;
     };
 
     /**
@@ -28,12 +311,100 @@ namespace csvd{
         Auto            ///< First row is automatically determined. If the first character of the first row is a: digit, `+`, `-` --> the row is assumed to be a datarow. Any other character --> assumed to be a named header row.
     };
 
+    /**
+     * @brief What a read does with data rows that cannot be parsed
+     *
+     * Rows are bad if a cell is no number or too long, or if they have more or fewer cells than the header.
+     * The read resynchronizes at the next line separator, so a corrupt line never affects the following rows.
+     */
+    enum class BadRows{
+        Fail,           ///< The read fails with the first error
+        Skip,           ///< The row is left out and its error is recorded
+        FillNaN,        ///< The row is kept with NaN in all columns and its error is recorded
+    };
+
+    /**
+     * @brief Keeps only rows whose value in a column lies within `[min, max]`
+     * 
+     * Predicates are evaluated while parsing. Rows that fail are skipped before
+     * their remaining cells are converted or stored. Rows with NaN in the column are dropped.
+     */
+    struct RowPredicate{
+        std::string column;                                     ///< Name of the tested column. If empty, `index` selects the column.
+        size_t index = 0;                                       ///< Index of the tested column, only used if `column` is empty.
+        double min = -std::numeric_limits<double>::infinity();  ///< Smallest value that is kept
+        double max = std::numeric_limits<double>::infinity();   ///< Largest value that is kept
+    };
+
     struct Settings{
         HeaderType header_type = HeaderType::Auto;
         std::array<char, 8> value_separators = {',', ';', '\t', '\0'};
         std::array<char, 8> line_separators = {'\n','\0'};
         std::array<char, 8> quotes = {'"', '\'','\0'};
         bool auto_quotes = true;
+        bool compute_statistics = false; ///< If `true`, `read` maintains the running `Column::statistics` of every column while parsing
+        std::vector<RowPredicate> row_predicates; ///< Rows that do not satisfy all predicates are skipped while reading
+        BadRows bad_rows = BadRows::Fail;   ///< Lenient reads record errors instead of failing, see `CSVd::errors`
+        size_t max_errors = 1000;           ///< Lenient reads still fail on the bad row after this many recorded errors
+    };
+
+    /**
+     * @brief Counters and phase timings of a read, to find out where the time of a slow read goes
+     *
+     * Only recorded if the library is built with `CSVD_ENABLE_STATS` (CMake option `csvd_enable_stats`).
+     * Otherwise the instrumentation is compiled out entirely and `recorded` stays `false`.
+     * The timings take a few clock reads per row, so an instrumented read is somewhat slower.
+     */
+    struct ReadStats{
+        bool recorded = false;                  ///< `true` if the counters have been recorded
+        size_t bytes = 0;                       ///< Bytes read from the stream
+        size_t rows = 0;                        ///< Parsed data rows, including the ones that failed a row predicate
+        size_t cells = 0;                       ///< Split cells
+        std::chrono::nanoseconds scan{0};       ///< Time spent finding lines and splitting them into cells
+        std::chrono::nanoseconds convert{0};    ///< Time spent converting cells into numbers
+        std::chrono::nanoseconds append{0};     ///< Time spent appending the values to the columns
+        size_t allocations = 0;                 ///< Memory blocks allocated for the parse buffers and the column storage
+        size_t memory = 0;                      ///< Bytes of the parse buffers, the values and the zones of the columns when the read ended, the largest over all accumulated reads
+    };
+
+    /**
+     * @brief The state of a read that is reported to `ReadControl::progress`
+     */
+    struct ReadProgress{
+        size_t bytes = 0;               ///< Bytes read from the stream so far
+        std::optional<size_t> total;    ///< The number of bytes of the stream, if it is seekable
+        size_t rows = 0;                ///< Data rows read so far
+    };
+
+    /**
+     * @brief Progress reports and cooperative cancellation for long reads
+     *
+     * Both are checked once per block of the stream (64 KiB) and the rows are counted once per row,
+     * never per cell, so the overhead is negligible.
+     *
+     * \code{.cpp}
+     * std::jthread worker([&](std::stop_token stop_token){
+     *     csvd::ReadControl control;
+     *     control.progress = [](const csvd::ReadProgress& progress){ std::cout << progress.bytes << " bytes\n"; };
+     *     control.stop_token = stop_token;
+     *     auto csv = csvd::read(file, csvd::Settings(), control);
+     * });
+     * worker.request_stop(); // the read returns `ErrorCase::Cancelled`
+     * \endcode
+     */
+    struct ReadControl{
+        std::function<void(const ReadProgress&)> progress;  ///< Called every `bytes_interval` bytes or `rows_interval` rows and once after the last row
+        size_t bytes_interval = size_t(1) << 24;            ///< Bytes between two progress reports, `0` disables them
+        size_t rows_interval = 0;                           ///< Rows between two progress reports, `0` disables them
+        std::stop_token stop_token;                         ///< Cancels the read with `ErrorCase::Cancelled` once a stop is requested
+    };
+
+    /**
+     * @brief Controls how column algorithms are distributed over threads
+     */
+    struct ParallelSettings{
+        size_t threshold = size_t(1) << 16; ///< Minimum number of rows per thread. Inputs smaller than this run on the calling thread.
+        unsigned int max_threads = 0;       ///< Upper limit of threads. `0` uses `std::thread::hardware_concurrency()`.
     };
 
     enum class ErrorCase{
@@ -45,6 +416,8 @@ namespace csvd{
         ExpectedLineSeparator,      ///< Expected a line-separator
         ExpectedValueSeparator,     
         CellTooLong,
+        UnknownColumn,              ///< A row predicate or a streaming operation refers to a column that does not exist.
+        Cancelled,                  ///< The read has been cancelled through `ReadControl::stop_token`.
     };
 
     class ReadError{
@@ -54,15 +427,19 @@ namespace csvd{
             std::array<char, 8> expected_;
             size_t col_;
             size_t row_;
+            std::uint64_t line_offset_;
+            std::uint64_t offset_;
             char peek_;
 
         public:
 
-            inline ReadError(ErrorCase error_case, std::string_view cell, const std::array<char, 8>& expected, size_t col, size_t row, char peek)
+            inline ReadError(ErrorCase error_case, std::string_view cell, const std::array<char, 8>& expected, size_t col, size_t row, char peek, std::uint64_t line_offset = 0, std::uint64_t offset = 0)
                 : error_case_(error_case)
                 , expected_(expected)
                 , col_(col)
                 , row_(row)
+                , line_offset_(line_offset)
+                , offset_(std::max(offset, line_offset))
                 , peek_(peek)
             {
                 size_t i = 0;
@@ -107,6 +484,20 @@ namespace csvd{
 
             inline size_t col() const {return this->col_;}
 
+            /**
+             * @brief Returns the byte offset of the start of the line at which the error happened
+             *
+             * The offset is absolute if the stream is seekable, otherwise it is counted from the position where the read started.
+             */
+            inline std::uint64_t line_offset() const {return this->line_offset_;}
+
+            /**
+             * @brief Returns the byte offset of the failing cell, or of its line if the error is not about a cell
+             *
+             * Together with `error_context` or `read_error_context` the line can be shown without parsing the source again.
+             */
+            inline std::uint64_t offset() const {return this->offset_;}
+
             void print(std::ostream& stream) const;
             
             friend inline std::ostream& operator<< (std::ostream& stream, const ReadError& error){
@@ -179,7 +570,10 @@ namespace csvd{
             inline size_type size() const {return this->columns_.size();}
             inline size_type max_size() const {return this->columns_.max_size();}
 
-            inline void clear() {this->columns_.clear();}
+            inline void clear() {
+                this->columns_.clear();
+                this->errors_.clear();
+            }
             
             inline iterator insert(const_iterator pos, const csvd::Column& value){return this->columns_.insert(pos, value);}
             inline iterator insert(const_iterator pos, csvd::Column&& value){return this->columns_.insert(pos, std::move(value));}
@@ -199,6 +593,7 @@ namespace csvd{
             void swap( CSVd& other ) noexcept {
                 std::swap(this->settings_, other.settings_);
                 std::swap(this->columns_, other.columns_);
+                std::swap(this->errors_, other.errors_);
             }
 
             /**
@@ -337,11 +732,20 @@ namespace csvd{
              * @brief Reds data from a CSV stream containing written data
              * 
              * Note that `read` has a character limit per cell entry of 128 characters.
+             * Rows that do not satisfy `Settings::row_predicates` are skipped.
              * 
              * @param stream The stream containing the CSV data
+             * @param stats Optionally receives the counters of the read, see `ReadStats`
              * @return An expected void on success or an error string that conatins an error message
              */
-            [[nodiscard]] tl::expected<void, ReadError> read(std::istream& stream);
+            [[nodiscard]] tl::expected<void, ReadError> read(std::istream& stream, ReadStats* stats = nullptr);
+
+            /**
+             * @brief Reads data from a CSV stream with progress reports and cancellation, see `ReadControl`
+             *
+             * The rows that have been read before a cancellation stay in the table.
+             */
+            [[nodiscard]] tl::expected<void, ReadError> read(std::istream& stream, const ReadControl& control, ReadStats* stats = nullptr);
 
             /**
              * @brief Writes the CSV data to the output stream
@@ -352,29 +756,30 @@ namespace csvd{
              */
             void write(std::ostream& stream) const;
 
-        private:
-
-            [[nodiscard]] tl::expected<void, ReadError> read_with_header(std::istream& stream);
-
-            [[nodiscard]] tl::expected<void, ReadError> read_without_header(std::istream& stream);
-
             /**
-             * @brief Reads characters from the string until a delimiter has been found
-             * 
-             * Will not read the delimiter from the stream. So the next character in the stream
-             * will be the delimiter or the end of the stream.
-             * 
-             * @param stream A reference to the stream object
-             * @param delimiter A list of delimiters
-             * @return A string containing all characters until the delimiter
+             * @brief Returns the errors of the rows that the last lenient read skipped or filled with NaN, see `Settings::bad_rows`
+             *
+             * \code{.cpp}
+             * csvd::Settings settings;
+             * settings.bad_rows = csvd::BadRows::Skip;
+             * auto csv = csvd::read(file, settings);
+             * for(const csvd::ReadError& error : csv->errors()){
+             *     std::cout << "skipped the line at byte " << error.line_offset() << ":\n" << error << std::endl;
+             * }
+             * \endcode
              */
-            [[nodiscard]] std::optional<std::string_view> read_cell(char* buffer_first, size_t buffer_size, std::istream& stream);
+            [[nodiscard]] inline const std::vector<ReadError>& errors() const {return this->errors_;}
+
+        private:
 
             std::deque<csvd::Column> columns_;
             Settings settings_;
+            std::vector<ReadError> errors_;
 
     }; // class CSVd
 
-    tl::expected<CSVd, ReadError> read(std::istream& stream, Settings settings = Settings());
+    tl::expected<CSVd, ReadError> read(std::istream& stream, Settings settings = Settings(), ReadStats* stats = nullptr);
+
+    tl::expected<CSVd, ReadError> read(std::istream& stream, Settings settings, const ReadControl& control, ReadStats* stats = nullptr);
 
 }// namespace csvd
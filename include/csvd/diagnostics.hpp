@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include <tl/expected.hpp>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief The line of the source around a `ReadError`
+     */
+    struct ErrorContext{
+        std::string line;               ///< The line without the line separator, cut around the cell if it is very long
+        std::uint64_t line_offset = 0;  ///< The byte offset of the first character of `line`
+        size_t position = 0;            ///< The index of the failing cell in `line`
+    };
+
+    /**
+     * @brief Prints the line and a marker under the failing cell
+     *
+     * \code{.unparsed}
+     * 10005, 1.5, x2
+     *             ^
+     * \endcode
+     */
+    std::ostream& operator<<(std::ostream& stream, const ErrorContext& context);
+
+    /**
+     * @brief Returns the line of an error in a buffer that has been read completely
+     *
+     * Jumps to `ReadError::offset` instead of scanning the buffer, so it is cheap even for the last line of a large file.
+     * The offsets of the error have to be relative to the start of the buffer.
+     *
+     * @param settings The line separators of the read
+     */
+    [[nodiscard]] ErrorContext error_context(std::string_view buffer, const ReadError& error, const Settings& settings = Settings());
+
+    /**
+     * @brief Returns the line of an error in a file, only the bytes around `ReadError::offset` are read
+     *
+     * \code{.cpp}
+     * std::ifstream file("log.csv");
+     * if(auto csv = csvd::read(file); !csv){
+     *     std::cout << csv.error() << csvd::read_error_context("log.csv", csv.error()).value_or(csvd::ErrorContext()) << std::endl;
+     * }
+     * \endcode
+     */
+    [[nodiscard]] tl::expected<ErrorContext, ReadError> read_error_context(const std::filesystem::path& path, const ReadError& error, const Settings& settings = Settings());
+
+}// namespace csvd
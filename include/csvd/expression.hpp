@@ -0,0 +1,137 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    namespace detail{
+        struct ExprNode;
+    }// namespace detail
+
+    /**
+     * @brief A lazy expression over the columns of a table
+     *
+     * Expressions are built from columns (`col`), constants, arithmetic and comparison operators and
+     * math functions. Building an expression does not compute anything. `evaluate` runs the whole tree
+     * in one pass over blocks of rows that stay in the L1 cache, so no intermediate column is ever allocated.
+     * Comparisons and logical operators yield `1` for true and `0` for false, non-zero values are true.
+     *
+     * \code{.cpp}
+     * using csvd::col;
+     * csvd::Column magnitude = csvd::evaluate(csv, csvd::hypot(col("Real"), col("Imag")), "Magnitude");
+     * csvd::Column scaled = csvd::evaluate(csv, col("Voltage") * 1.5 + 0.2, "Scaled");
+     * \endcode
+     */
+    class Expr{
+        public:
+
+            /**
+             * @brief A constant
+             */
+            Expr(double value);
+
+            /**
+             * @brief Wraps a node of the expression tree. Used internally by the operators.
+             */
+            explicit Expr(std::shared_ptr<const detail::ExprNode> node);
+
+            /**
+             * @brief Returns the names of all columns that the expression uses, without duplicates
+             */
+            [[nodiscard]] std::vector<std::string> columns() const;
+
+            [[nodiscard]] inline const std::shared_ptr<const detail::ExprNode>& node() const {return this->node_;}
+
+        private:
+            std::shared_ptr<const detail::ExprNode> node_;
+    };
+
+    /**
+     * @brief A column that is referred to by name. The name is resolved on evaluation.
+     */
+    [[nodiscard]] Expr col(std::string name);
+
+    [[nodiscard]] Expr operator+(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator-(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator*(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator/(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator-(const Expr& a);
+
+    [[nodiscard]] Expr operator<(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator<=(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator>(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator>=(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator==(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator!=(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator&&(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator||(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr operator!(const Expr& a);
+
+    [[nodiscard]] Expr abs(const Expr& a);
+    [[nodiscard]] Expr sqrt(const Expr& a);
+    [[nodiscard]] Expr exp(const Expr& a);
+    [[nodiscard]] Expr log(const Expr& a);
+    [[nodiscard]] Expr log10(const Expr& a);
+    [[nodiscard]] Expr sin(const Expr& a);
+    [[nodiscard]] Expr cos(const Expr& a);
+    [[nodiscard]] Expr tan(const Expr& a);
+    [[nodiscard]] Expr atan(const Expr& a);
+    [[nodiscard]] Expr floor(const Expr& a);
+    [[nodiscard]] Expr ceil(const Expr& a);
+    [[nodiscard]] Expr isnan(const Expr& a);
+    [[nodiscard]] Expr pow(const Expr& base, const Expr& exponent);
+    [[nodiscard]] Expr atan2(const Expr& y, const Expr& x);
+    [[nodiscard]] Expr hypot(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr min(const Expr& a, const Expr& b);
+    [[nodiscard]] Expr max(const Expr& a, const Expr& b);
+
+    /**
+     * @brief Element-wise `condition ? a : b`
+     */
+    [[nodiscard]] Expr where(const Expr& condition, const Expr& a, const Expr& b);
+
+    /**
+     * @brief An expression with the name of the column that it produces
+     */
+    struct NamedExpr{
+        std::string name;
+        Expr expression;
+    };
+
+    /**
+     * @brief Evaluates the expression for every row of the table into a new column
+     *
+     * The result has as many rows as the shortest column that the expression uses.
+     *
+     * @param table The table that provides the columns
+     * @param expression The expression to evaluate
+     * @param name The name of the resulting column
+     * @param parallel Controls the multi-threading of large tables
+     * @throws std::out_of_range if the expression uses a column that does not exist
+     */
+    [[nodiscard]] Column evaluate(const CSVd& table, const Expr& expression, std::string name = std::string(), const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Evaluates the expressions and writes them as CSV without materializing the columns
+     *
+     * Uses the settings of the table for the output format. Only as many rows as the shortest used column has are written.
+     *
+     * \code{.cpp}
+     * using csvd::col;
+     * csvd::write(stream, csv, {
+     *     {"Frequency", col("Frequencies (Hz)")},
+     *     {"Magnitude", csvd::hypot(col("Real"), col("Imag"))},
+     *     {"Phase", csvd::atan2(col("Imag"), col("Real"))},
+     * });
+     * \endcode
+     *
+     * @throws std::out_of_range if an expression uses a column that does not exist
+     */
+    void write(std::ostream& stream, const CSVd& table, const std::vector<NamedExpr>& columns);
+
+}// namespace csvd
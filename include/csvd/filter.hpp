@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief Comparison operators for `compare`
+     */
+    enum class Comparison{
+        Less,           ///< `value < x`
+        LessEqual,      ///< `value <= x`
+        Greater,        ///< `value > x`
+        GreaterEqual,   ///< `value >= x`
+        Equal,          ///< `value == x`
+        NotEqual,       ///< `value != x`
+    };
+
+    /**
+     * @brief A set of selected rows, stored as a bitmap
+     *
+     * Selections are produced by `compare` and `between` and can be combined with
+     * the boolean operators before the table is compacted once with `filter`.
+     * Bits beyond `size()` are always zero.
+     */
+    class Selection{
+        public:
+
+            Selection() = default;
+
+            /**
+             * @brief Creates a selection of `rows` rows that are either all selected or none
+             */
+            explicit Selection(size_t rows, bool selected = false);
+
+            /**
+             * @brief Returns the number of rows the selection covers
+             */
+            [[nodiscard]] inline size_t size() const {return this->size_;}
+
+            /**
+             * @brief Returns the number of selected rows
+             */
+            [[nodiscard]] size_t count() const;
+
+            [[nodiscard]] inline bool operator[](size_t row) const {
+                return (this->words_[row / 64] >> (row % 64)) & 1u;
+            }
+
+            inline void set(size_t row, bool selected = true){
+                const std::uint64_t bit = std::uint64_t(1) << (row % 64);
+                if(selected){
+                    this->words_[row / 64] |= bit;
+                }else{
+                    this->words_[row / 64] &= ~bit;
+                }
+            }
+
+            /**
+             * @brief Returns the indices of all selected rows in ascending order
+             */
+            [[nodiscard]] std::vector<size_t> indices() const;
+
+            /**
+             * @brief Access to the underlying bitmap. Row `i` is bit `i % 64` of word `i / 64`.
+             */
+            [[nodiscard]] inline std::span<const std::uint64_t> words() const {return this->words_;}
+            [[nodiscard]] inline std::span<std::uint64_t> words() {return this->words_;}
+
+            /**
+             * @brief Intersection. Rows that are only covered by one of the selections are not selected.
+             */
+            Selection& operator&=(const Selection& other);
+
+            /**
+             * @brief Union. The result covers the rows of both selections.
+             */
+            Selection& operator|=(const Selection& other);
+
+            /**
+             * @brief Inverts the selection
+             */
+            [[nodiscard]] Selection operator~() const;
+
+            friend inline Selection operator&(Selection lhs, const Selection& rhs){return lhs &= rhs;}
+            friend inline Selection operator|(Selection lhs, const Selection& rhs){return lhs |= rhs;}
+
+        private:
+
+            void clear_tail();
+
+            std::vector<std::uint64_t> words_;
+            size_t size_ = 0;
+    };
+
+    /**
+     * @brief Selects all rows where `column[row] <comparison> value` is `true`
+     *
+     * Rows containing NaN are only selected by `Comparison::NotEqual`.
+     * Blocks whose `Column::zones` cannot match, or match completely, are not read.
+     */
+    [[nodiscard]] Selection compare(const Column& column, Comparison comparison, double value, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Selects all rows where `a[row] <comparison> b[row]` is `true`
+     *
+     * The selection covers the rows that both columns have.
+     */
+    [[nodiscard]] Selection compare(const Column& a, Comparison comparison, const Column& b, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Selects all rows where `min <= column[row] <= max`
+     *
+     * Uses the `Column::zones` to skip blocks outside of the range, see `compare`.
+     */
+    [[nodiscard]] Selection between(const Column& column, double min, double max, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Returns a new table with only the selected rows
+     *
+     * All columns are compacted with a single pass over the selection.
+     * Rows beyond the end of the selection are dropped.
+     */
+    [[nodiscard]] CSVd filter(const CSVd& table, const Selection& selection, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Returns a new table with the given rows in the given order
+     *
+     * Rows that are out of range for a column are skipped for that column.
+     */
+    [[nodiscard]] CSVd take(const CSVd& table, std::span<const size_t> rows, const ParallelSettings& parallel = ParallelSettings());
+
+}// namespace csvd
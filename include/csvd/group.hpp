@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief Aggregate functions of `GroupBy::aggregate`
+     *
+     * NaN values are ignored by all functions, like in pandas.
+     */
+    enum class Aggregate{
+        Sum,    ///< Sum of the values, `0` if there are none
+        Mean,   ///< Arithmetic mean, NaN if there are no values
+        Min,    ///< Smallest value, NaN if there are no values
+        Max,    ///< Largest value, NaN if there are no values
+        Count,  ///< Number of values that are not NaN
+    };
+
+    /**
+     * @brief One aggregated output column: a function applied to a value column
+     */
+    struct Aggregation{
+        std::string column;     ///< The name of the value column
+        Aggregate function;     ///< The function applied per group
+    };
+
+    /**
+     * @brief Rows of a table grouped by equal values in the key columns
+     *
+     * Created by `group_by`. Only stores a reference to the table, which has to outlive this object.
+     */
+    class GroupBy{
+        public:
+            GroupBy(const CSVd& table, std::vector<std::string> keys, const ParallelSettings& parallel = ParallelSettings());
+
+            /**
+             * @brief Computes the aggregations for every group
+             *
+             * The result contains the key columns followed by one column per aggregation, named
+             * `<column>_sum`, `<column>_mean`, `<column>_min`, `<column>_max` or `<column>_count`.
+             * It has one row per group, sorted ascending by the keys. All NaN keys form one group that is sorted last.
+             *
+             * If the keys are already sorted, groups are formed by a linear scan over the runs of equal keys.
+             * Otherwise every thread builds an open addressing hash table of partial aggregates over
+             * a range of rows, and the partial tables are merged at the end.
+             *
+             * @throws std::out_of_range if a key or value column does not exist
+             */
+            [[nodiscard]] CSVd aggregate(const std::vector<Aggregation>& aggregations) const;
+
+        private:
+            const CSVd* table_;
+            std::vector<std::string> keys_;
+            ParallelSettings parallel_;
+    };
+
+    /**
+     * @brief Groups the rows of a table by equal values in the key columns
+     *
+     * \code{.cpp}
+     * csvd::CSVd report = csvd::group_by(csv, {"Channel"}).aggregate({
+     *     {"Voltage", csvd::Aggregate::Mean},
+     *     {"Voltage", csvd::Aggregate::Max},
+     *     {"Voltage", csvd::Aggregate::Count},
+     * });
+     * \endcode
+     *
+     * @param table The table to group. Has to outlive the returned object.
+     * @param keys The names of the key columns
+     * @param parallel Controls the multi-threading of large tables
+     */
+    [[nodiscard]] GroupBy group_by(const CSVd& table, std::vector<std::string> keys, const ParallelSettings& parallel = ParallelSettings());
+
+}// namespace csvd
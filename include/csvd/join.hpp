@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <limits>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief Naming of the joined table
+     */
+    struct JoinSettings{
+        std::string left_suffix = "_left";      ///< Appended to left column names that also exist in the right table
+        std::string right_suffix = "_right";    ///< Appended to right column names that also exist in the left table
+    };
+
+    /**
+     * @brief Joins two tables on equal key values and keeps only rows that have a partner
+     *
+     * The result contains all columns of the left table followed by the columns of the right table
+     * without its key column. Every pair of rows with equal keys produces one output row.
+     * Rows are ordered by the left row and then by the right row. NaN keys never match.
+     *
+     * If both key columns are sorted ascending a linear merge join is used, otherwise a
+     * radix-partitioned hash join. Large tables are processed on multiple threads.
+     *
+     * @param left The left table
+     * @param right The right table
+     * @param left_key The name of the key column in the left table
+     * @param right_key The name of the key column in the right table
+     * @param settings Controls the naming of duplicate columns
+     * @param parallel Controls the multi-threading of large tables
+     * @throws std::out_of_range if a key column does not exist
+     */
+    [[nodiscard]] CSVd inner_join(const CSVd& left, const CSVd& right, std::string_view left_key, std::string_view right_key,
+        const JoinSettings& settings = JoinSettings(), const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Joins two tables on equal key values and keeps every row of the left table
+     *
+     * Same as `inner_join`, but left rows without a partner appear once with NaN in all right columns.
+     *
+     * @throws std::out_of_range if a key column does not exist
+     */
+    [[nodiscard]] CSVd left_join(const CSVd& left, const CSVd& right, std::string_view left_key, std::string_view right_key,
+        const JoinSettings& settings = JoinSettings(), const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Selects the right row that is attached to a left row in `asof_join`
+     */
+    enum class AsofDirection{
+        Backward,       ///< The last right row at or before the left time
+        Forward,        ///< The first right row at or after the left time
+        Nearest,        ///< The closer one of `Backward` and `Forward`, `Backward` on ties
+        Interpolate,    ///< Linear interpolation between the `Backward` and `Forward` rows
+    };
+
+    /**
+     * @brief Settings of `asof_join`
+     */
+    struct AsofSettings{
+        AsofDirection direction = AsofDirection::Backward;
+        double tolerance = std::numeric_limits<double>::infinity(); ///< Right rows further away than this are not attached
+        JoinSettings naming;                                        ///< Suffixes for duplicate column names
+    };
+
+    /**
+     * @brief Attaches to every left row the right row that is closest in time
+     *
+     * Joins two time series that were sampled at different times. Both time columns have to be
+     * sorted ascending. Every left row appears exactly once; if there is no suitable right row
+     * (or it is further away than the tolerance) the right columns are NaN.
+     * The result contains all left columns followed by the right columns without the time column.
+     *
+     * Runs as one linear merge of both time columns, split into time partitions for multiple threads.
+     *
+     * \code{.cpp}
+     * csvd::AsofSettings settings;
+     * settings.direction = csvd::AsofDirection::Interpolate;
+     * csvd::CSVd aligned = csvd::asof_join(fast_sensor, slow_sensor, "Time", "Time", settings);
+     * \endcode
+     *
+     * @throws std::out_of_range if a time column does not exist
+     * @throws std::invalid_argument if a time column is not sorted ascending
+     */
+    [[nodiscard]] CSVd asof_join(const CSVd& left, const CSVd& right, std::string_view left_time, std::string_view right_time,
+        const AsofSettings& settings = AsofSettings(), const ParallelSettings& parallel = ParallelSettings());
+
+}// namespace csvd
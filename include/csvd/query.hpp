@@ -0,0 +1,130 @@
+#pragma once
+
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <tl/expected.hpp>
+
+#include <csvd/csvd.hpp>
+#include <csvd/expression.hpp>
+#include <csvd/group.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief A lazy pipeline `read → derive/filter → select → collect/write/aggregate` over a CSV stream
+     *
+     * The steps are only recorded until one of the terminal operations runs the query. The query is
+     * then planned once: only the columns that are used by any step or by the output are converted
+     * by the parser, and the rows are processed in chunks of cache sized blocks, so no intermediate
+     * table is ever materialized. `write` and `aggregate` run in constant memory.
+     *
+     * Derived columns can be used by all following steps. A query can only be executed once,
+     * because it consumes the stream.
+     *
+     * \code{.cpp}
+     * using csvd::col;
+     * std::ifstream file("bode.csv");
+     * auto result = csvd::Query(file)
+     *     .derive("Magnitude", csvd::hypot(col("Real"), col("Imag")))
+     *     .filter(col("Magnitude") > 0.5)
+     *     .select({"Frequencies (Hz)", "Magnitude"})
+     *     .write(std::cout);
+     * \endcode
+     */
+    class Query{
+        public:
+
+            /**
+             * @brief Creates a query that reads from the stream. The stream has to outlive the query.
+             */
+            explicit Query(std::istream& stream, Settings settings = Settings());
+
+            /**
+             * @brief Selects the output columns and their order. Without a selection all read columns are followed by the derived ones.
+             */
+            Query& select(std::vector<std::string> columns);
+
+            /**
+             * @brief Keeps only rows for which the condition is non-zero
+             */
+            Query& filter(Expr condition);
+
+            /**
+             * @brief Adds a computed column that later steps and the output can use
+             */
+            Query& derive(std::string name, Expr expression);
+
+            /**
+             * @brief Runs the query and returns the selected columns as a table
+             */
+            [[nodiscard]] tl::expected<CSVd, ReadError> collect();
+
+            /**
+             * @brief Runs the query and writes the selected columns as CSV with the settings of the query
+             */
+            [[nodiscard]] tl::expected<void, ReadError> write(std::ostream& stream);
+
+            /**
+             * @brief Runs the query and aggregates the rows per group of equal keys, see `GroupBy::aggregate`
+             *
+             * Only the partial aggregates of the groups are held in memory. Without keys the result has one row.
+             */
+            [[nodiscard]] tl::expected<CSVd, ReadError> aggregate(std::vector<std::string> keys, const std::vector<Aggregation>& aggregations);
+
+        private:
+
+            struct Step{
+                std::string name;   ///< Empty for filters
+                Expr expression;
+                bool is_filter;
+            };
+
+            /**
+             * @brief Executes the query, calls `begin(output_names)` once and then `emit(values)` for every output row
+             *
+             * @param outputs The output columns, `nullptr` for the selection of the query
+             */
+            template<class Begin, class Emit>
+            [[nodiscard]] tl::expected<void, ReadError> run(const std::vector<std::string>* outputs, Begin&& begin, Emit&& emit);
+
+            [[nodiscard]] std::vector<std::string> output_names(const std::vector<std::string>& file_columns) const;
+
+            std::istream& stream_;
+            Settings settings_;
+            std::vector<Step> steps_;
+            std::vector<std::string> selection_;
+            bool has_selection_ = false;
+    };
+
+    /**
+     * @brief A row that has been found by `find_first_row`
+     */
+    struct FoundRow{
+        size_t row;                 ///< The zero based line index in the file, see `Reader::row`
+        std::vector<double> values; ///< The values of all columns of the row
+    };
+
+    /**
+     * @brief Returns the first row of a CSV stream for which the predicate is non-zero
+     *
+     * Only the columns that the predicate uses are converted while scanning. The remaining cells are
+     * converted for the matching row only, and parsing stops right there, so the rest of the stream is never read.
+     *
+     * \code{.cpp}
+     * using csvd::col;
+     * std::ifstream file("bode.csv");
+     * auto found = csvd::find_first_row(file, csvd::hypot(col("Real"), col("Imag")) > 0.5);
+     * if(found && *found){
+     *     std::cout << "line " << (*found)->row << std::endl;
+     * }
+     * \endcode
+     *
+     * @return The row or `std::nullopt` if no row matches
+     */
+    [[nodiscard]] tl::expected<std::optional<FoundRow>, ReadError> find_first_row(std::istream& stream, const Expr& predicate, Settings settings = Settings());
+
+}// namespace csvd
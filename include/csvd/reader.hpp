@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <span>
+#include <istream>
+
+#include <tl/expected.hpp>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief Streaming CSV parser that reads one row at a time
+     *
+     * The stream is consumed in large blocks and split into lines. Cells are only converted
+     * after the row passed the `Settings::row_predicates`, so rows that are dropped cost
+     * little more than the scan for the next line separator.
+     * `CSVd::read` is built on top of this reader.
+     *
+     * \code{.cpp}
+     * csvd::Reader reader(stream, settings);
+     * if(auto header = reader.read_header(); !header){
+     *     std::cout << header.error() << std::endl;
+     * }
+     * while(true){
+     *     tl::expected<bool, csvd::ReadError> row = reader.next_row();
+     *     if(!row) { std::cout << row.error() << std::endl; break; }
+     *     if(!*row) break; // end of file
+     *     use(reader.values());
+     * }
+     * \endcode
+     */
+    class Reader{
+        public:
+
+            /**
+             * @brief Creates a reader on the stream. The stream has to outlive the reader.
+             */
+            explicit Reader(std::istream& stream, Settings settings = Settings());
+
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+
+            /**
+             * @brief Reads the header and determines the number of columns
+             *
+             * Has to be called once before `next_row()`. Without a header the first data row is
+             * only inspected and later returned by `next_row()`.
+             */
+            [[nodiscard]] tl::expected<void, ReadError> read_header();
+
+            /**
+             * @brief Restricts the conversion to the given columns, the values of all other columns are NaN
+             *
+             * Cells of the other columns are still split but never parsed, which saves most of the work
+             * if only a few columns of a wide file are needed. Columns with a row predicate are always converted.
+             * Has to be called after `read_header()`.
+             */
+            void select_columns(std::span<const size_t> columns);
+
+            /**
+             * @brief Converts the cells of the current row that have been skipped by `select_columns`
+             *
+             * Lets a scan convert only a few columns and the complete row once it found what it was looking for.
+             * The skipped columns of the following rows are NaN again.
+             */
+            [[nodiscard]] tl::expected<void, ReadError> convert_remaining();
+
+            /**
+             * @brief Parses the next row that satisfies all row predicates
+             *
+             * @return `true` if a row has been read, `false` at the end of the stream or a `ReadError`
+             */
+            [[nodiscard]] tl::expected<bool, ReadError> next_row();
+
+            /**
+             * @brief Returns the column names. Empty names if the file has no header.
+             */
+            [[nodiscard]] inline const std::vector<std::string>& names() const {return this->names_;}
+
+            /**
+             * @brief Returns the number of columns
+             */
+            [[nodiscard]] inline size_t columns() const {return this->names_.size();}
+
+            /**
+             * @brief Returns the values of the current row
+             */
+            [[nodiscard]] inline std::span<const double> values() const {return this->values_;}
+
+            /**
+             * @brief Returns the cells of the current row as they are in the stream, without surrounding whitespaces
+             *
+             * Quotes are kept. The views are valid until the next call to `next_row()`.
+             * Rows that are kept by `BadRows::FillNaN` have `nan` in all cells.
+             */
+            [[nodiscard]] inline std::span<const std::string_view> cells() const {return this->cells_;}
+
+            /**
+             * @brief Returns the zero based line index of the current row
+             */
+            [[nodiscard]] inline size_t row() const {return this->row_;}
+
+            /**
+             * @brief Returns the byte offset of the start of the current row
+             *
+             * The offset is absolute if the stream is seekable, otherwise it is counted from the position where the reader started.
+             */
+            [[nodiscard]] inline std::uint64_t line_offset() const {return this->line_offset_;}
+
+            /**
+             * @brief Returns the errors of the rows that have been skipped or filled with NaN, see `Settings::bad_rows`
+             */
+            [[nodiscard]] inline const std::vector<ReadError>& errors() const {return this->errors_;}
+
+            [[nodiscard]] inline const Settings& settings() const {return this->settings_;}
+
+            /**
+             * @brief Enables progress reports and cancellation, see `ReadControl`
+             *
+             * Has to be called before `read_header()`. The size of the stream is determined once if it is seekable.
+             */
+            void set_control(ReadControl control);
+
+            /**
+             * @brief Accumulates the counters of the following reads into `stats`, see `ReadStats`
+             *
+             * `stats` has to outlive the reader. Pass `nullptr` to stop recording.
+             */
+            inline void set_stats(ReadStats* stats){this->stats_ = stats;}
+
+            [[nodiscard]] inline ReadStats* stats() const {return this->stats_;}
+
+            /**
+             * @brief Returns the number of bytes held by the buffers of the reader
+             */
+            [[nodiscard]] size_t memory() const;
+
+        private:
+
+            struct Bounds{
+                double min;
+                double max;
+            };
+
+            [[nodiscard]] tl::expected<bool, ReadError> next_line(std::string_view& line, char& separator);
+
+            [[nodiscard]] tl::expected<bool, ReadError> parse_row(std::string_view line, char separator);
+
+            /**
+             * @brief Records the error of a bad row if `Settings::bad_rows` allows it, returns `false` if the read has to fail
+             */
+            [[nodiscard]] bool tolerate(const ReadError& error);
+
+            /**
+             * @brief Returns the byte offset of a view into the current line
+             */
+            [[nodiscard]] std::uint64_t offset_of(std::string_view text) const;
+
+            [[nodiscard]] tl::expected<void, ReadError> resolve_predicates();
+
+            [[nodiscard]] bool fill();
+
+            void report_progress();
+
+            [[nodiscard]] tl::expected<void, ReadError> convert(std::string_view cell, size_t column);
+
+            void reset_skipped_values();
+
+            std::istream& stream_;
+            Settings settings_;
+
+            std::array<unsigned char, 256> char_class_{};   ///< Flags per character, see `reader.cpp`
+            char single_line_separator_ = '\0';             ///< Set if there is only one line separator, enables `memchr`
+
+            std::vector<char> buffer_;
+            size_t position_ = 0;
+            size_t end_ = 0;
+            bool stream_end_ = false;
+            std::string carry_; ///< Holds lines that span over two buffer blocks
+            std::uint64_t consumed_ = 0;        ///< Bytes of the stream before the current block
+            std::uint64_t line_offset_ = 0;
+            std::string_view line_;             ///< The line that is parsed, for the byte offsets of errors
+
+            std::string_view pending_line_;
+            std::uint64_t pending_line_offset_ = 0;
+            char pending_separator_ = '\0';
+            bool has_pending_line_ = false;
+
+            std::vector<std::string> names_;
+            std::vector<std::string_view> cells_;
+            std::vector<double> values_;
+            std::vector<unsigned char> has_predicate_;
+            std::vector<unsigned char> convert_;   ///< `1` for the columns that are converted, see `select_columns`
+            bool has_skipped_values_ = false;      ///< Set by `convert_remaining`, the skipped columns have to be reset to NaN
+            std::vector<Bounds> bounds_;
+            size_t lines_ = 0;
+            size_t row_ = 0;
+            std::vector<ReadError> errors_;
+
+            ReadControl control_;
+            bool has_control_ = false;      ///< Set if there is a progress callback or a stop token
+            ReadProgress progress_;
+            size_t next_bytes_report_ = 0;
+            size_t next_rows_report_ = 0;
+            bool reported_end_ = false;     ///< Set once the final progress report has been sent
+
+            ReadStats* stats_ = nullptr;
+            std::chrono::steady_clock::time_point phase_start_;    ///< Start of the current phase, only used for `ReadStats`
+    };
+
+}// namespace csvd
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+
+#include <tl/expected.hpp>
+
+#include <csvd/csvd.hpp>
+#include <csvd/reader.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief How values between two samples are computed by `resample`
+     */
+    enum class Interpolation{
+        Linear,         ///< Linear interpolation between the neighbouring samples
+        Nearest,        ///< The closer neighbouring sample, the earlier one on ties
+        ZeroOrderHold,  ///< The last sample at or before the grid point
+    };
+
+    /**
+     * @brief Returns `count` evenly spaced points from `first` to `last` (inclusive)
+     */
+    [[nodiscard]] std::vector<double> uniform_grid(double first, double last, size_t count);
+
+    /**
+     * @brief Returns `count` logarithmically spaced points from `first` to `last` (inclusive), as used for frequency sweeps
+     *
+     * @throws std::invalid_argument if `first` or `last` is not positive
+     */
+    [[nodiscard]] std::vector<double> logarithmic_grid(double first, double last, size_t count);
+
+    /**
+     * @brief Resamples rows that are pushed one at a time onto a grid
+     *
+     * Keeps only the previous row, so the input can be streamed. For every pushed row all grid points
+     * up to its axis value are emitted, all columns at once. Grid points outside of the sampled range are NaN.
+     */
+    class Resampler{
+        public:
+
+            /**
+             * @param names The column names of the rows
+             * @param axis The index of the axis column, e.g. time or frequency
+             * @param grid The new axis values, have to be sorted ascending
+             * @param interpolation How values between two samples are computed
+             * @param settings The settings of the result
+             * @throws std::invalid_argument if the grid is not sorted ascending or `axis` is not a column
+             */
+            Resampler(std::vector<std::string> names, size_t axis, std::vector<double> grid,
+                Interpolation interpolation = Interpolation::Linear, const Settings& settings = Settings());
+
+            /**
+             * @brief Adds the next row. Rows with a NaN axis value are skipped.
+             *
+             * @throws std::invalid_argument if the axis value is smaller than the one of the previous row
+             */
+            void push(std::span<const double> row);
+
+            /**
+             * @brief Emits the grid points behind the last row and returns the resampled table
+             */
+            [[nodiscard]] CSVd finish();
+
+        private:
+            void emit_row(double x, std::span<const double> row);
+            void emit_nan(double x);
+
+            CSVd result_;
+            size_t axis_;
+            std::vector<double> grid_;
+            Interpolation interpolation_;
+            size_t next_ = 0;               ///< The next grid point to emit
+            std::vector<double> previous_;  ///< Empty before the first row
+            std::vector<double> output_;
+    };
+
+    /**
+     * @brief Replaces every `factor` consecutive rows that are pushed one at a time by their mean
+     *
+     * A NaN value makes the mean of its column NaN. The last group may have fewer rows.
+     */
+    class Decimator{
+        public:
+            /**
+             * @throws std::invalid_argument if `factor` is zero
+             */
+            Decimator(std::vector<std::string> names, size_t factor, const Settings& settings = Settings());
+
+            void push(std::span<const double> row);
+
+            /**
+             * @brief Emits the last incomplete group and returns the decimated table
+             */
+            [[nodiscard]] CSVd finish();
+
+        private:
+            void emit();
+
+            CSVd result_;
+            size_t factor_;
+            size_t count_ = 0;
+            std::vector<double> sum_;
+    };
+
+    /**
+     * @brief Maps all columns of the table onto a new grid of the axis column
+     *
+     * \code{.cpp}
+     * csvd::CSVd bode = csvd::resample(csv, "Frequencies (Hz)", csvd::logarithmic_grid(0.1, 1000, 200));
+     * \endcode
+     *
+     * @param table The table, has to be sorted ascending by the axis column
+     * @param axis The name of the axis column
+     * @param grid The new axis values, have to be sorted ascending
+     * @param interpolation How values between two samples are computed
+     * @throws std::out_of_range if the axis column does not exist
+     * @throws std::invalid_argument if the axis or the grid is not sorted ascending
+     */
+    [[nodiscard]] CSVd resample(const CSVd& table, std::string_view axis, std::vector<double> grid, Interpolation interpolation = Interpolation::Linear);
+
+    /**
+     * @brief Same as `resample(const CSVd&, ...)` but reads the rows directly from the parser
+     *
+     * Only the resampled table is held in memory. Reads the header of the reader first.
+     *
+     * @return The resampled table or the `ReadError` of the parser. `ErrorCase::UnknownColumn` if the axis column does not exist.
+     * @throws std::invalid_argument if the axis or the grid is not sorted ascending
+     */
+    [[nodiscard]] tl::expected<CSVd, ReadError> resample(Reader& reader, std::string_view axis, std::vector<double> grid, Interpolation interpolation = Interpolation::Linear);
+
+    /**
+     * @brief Replaces every `factor` consecutive rows of the table by their mean
+     *
+     * @throws std::invalid_argument if `factor` is zero
+     */
+    [[nodiscard]] CSVd decimate(const CSVd& table, size_t factor);
+
+    /**
+     * @brief Same as `decimate(const CSVd&, ...)` but reads the rows directly from the parser
+     *
+     * Reads the header of the reader first.
+     */
+    [[nodiscard]] tl::expected<CSVd, ReadError> decimate(Reader& reader, size_t factor);
+
+}// namespace csvd
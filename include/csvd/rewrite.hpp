@@ -0,0 +1,40 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <tl/expected.hpp>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief Rewrites a CSV stream with a subset of its columns, a new column order or a different format
+     *
+     * Rows are split by the `Reader` and written by the `Writer` one at a time. The cells are never
+     * converted to numbers: they are copied byte for byte, only without surrounding whitespaces,
+     * so the rewrite is bound by memory bandwidth instead of number parsing and formatting.
+     * Cells that contain a separator of the output format are quoted. Row predicates of the
+     * input settings still filter the rows, only their columns are converted.
+     *
+     * \code{.cpp}
+     * csvd::Settings semicolons;
+     * semicolons.value_separators = {';', '\0'};
+     * csvd::Settings commas;
+     * commas.value_separators = {',', '\0'};
+     * auto result = csvd::rewrite(input, output, {"Time", "Voltage"}, semicolons, commas);
+     * \endcode
+     *
+     * @param input The stream to read
+     * @param output The stream to write
+     * @param columns The names of the output columns in their new order. Empty to keep all columns.
+     * @param input_settings The format of the input
+     * @param output_settings The format of the output
+     */
+    [[nodiscard]] tl::expected<void, ReadError> rewrite(std::istream& input, std::ostream& output, const std::vector<std::string>& columns,
+        Settings input_settings = Settings(), Settings output_settings = Settings());
+
+}// namespace csvd
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <ranges>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief A contiguous range of rows `[first, last)`
+     *
+     * The same range applies to all columns of a table, see `slice`.
+     */
+    struct RowRange{
+        size_t first = 0;
+        size_t last = 0;
+
+        [[nodiscard]] constexpr size_t size() const {return this->last - this->first;}
+        [[nodiscard]] constexpr bool empty() const {return this->first == this->last;}
+    };
+
+    /**
+     * @brief A view onto the rows of one column without copying them
+     */
+    using ColumnSlice = std::ranges::subrange<std::deque<double>::const_iterator>;
+
+    /**
+     * @brief Returns the rows of the range as a view into the column
+     *
+     * The range is clamped to the size of the column. The view is invalidated if values are appended to the column.
+     *
+     * \code{.cpp}
+     * const csvd::RowRange window = csvd::find_range(*csv.find("Time"), 10.0, 20.0);
+     * for(const double voltage : csvd::slice(*csv.find("Voltage"), window)){ ... }
+     * \endcode
+     */
+    [[nodiscard]] ColumnSlice slice(const Column& column, RowRange rows);
+
+    /**
+     * @brief Returns the first row that does not come before `value` in the order of the sorted column
+     *
+     * For ascending columns this is the first row with a value `>= value`, for descending columns
+     * the first row with a value `<= value`. Uses a binary search.
+     *
+     * @throws std::invalid_argument if the column is not sorted, see `Column::order`
+     */
+    [[nodiscard]] size_t lower_bound(const Column& column, double value);
+
+    /**
+     * @brief Returns the first row that comes after `value` in the order of the sorted column
+     *
+     * @throws std::invalid_argument if the column is not sorted
+     */
+    [[nodiscard]] size_t upper_bound(const Column& column, double value);
+
+    /**
+     * @brief Returns the rows of a sorted column that are equal to `value`
+     *
+     * @throws std::invalid_argument if the column is not sorted
+     */
+    [[nodiscard]] RowRange equal_range(const Column& column, double value);
+
+    /**
+     * @brief Returns the rows of a sorted column with values in `[min, max]`, e.g. a time window
+     *
+     * @throws std::invalid_argument if the column is not sorted
+     */
+    [[nodiscard]] RowRange find_range(const Column& column, double min, double max);
+
+}// namespace csvd
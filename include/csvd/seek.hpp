@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include <tl/expected.hpp>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief Finds the first data row of a file whose value in a column is not less than `value`
+     *
+     * The column has to be sorted ascending, e.g. the time of a log. Instead of parsing the file,
+     * the byte offsets are bisected: every probe jumps into the middle of the remaining range, resyncs
+     * to the start of the next line and only converts the key cell of that line. A lookup takes
+     * O(log(file size)) probes of a few bytes each, independent of the number of rows.
+     * Quoted cells must not contain line separators.
+     *
+     * \code{.cpp}
+     * tl::expected<std::uint64_t, csvd::ReadError> offset = csvd::seek_value("log.csv", "Time", 3600.0);
+     * \endcode
+     *
+     * @param path The file to search
+     * @param column The name of the sorted column
+     * @param value The value to search for
+     * @param settings The format of the file. Row predicates are ignored.
+     * @return The byte offset of the start of the row or the size of the file if all values are less than `value`
+     */
+    [[nodiscard]] tl::expected<std::uint64_t, ReadError> seek_value(const std::filesystem::path& path, std::string_view column, double value, const Settings& settings = Settings());
+
+    /**
+     * @brief Same as `seek_value` but selects the column by index, e.g. for files without a header
+     */
+    [[nodiscard]] tl::expected<std::uint64_t, ReadError> seek_value(const std::filesystem::path& path, size_t column, double value, const Settings& settings = Settings());
+
+    /**
+     * @brief Reads only the rows with values in `[min, max]` of a column that is sorted ascending
+     *
+     * Seeks to `min` with `seek_value` and parses rows until the first value greater than `max`,
+     * so a time window is extracted from a large file without reading the rest of it.
+     *
+     * \code{.cpp}
+     * tl::expected<csvd::CSVd, csvd::ReadError> window = csvd::read_range("log.csv", "Time", 3600.0, 7200.0);
+     * \endcode
+     *
+     * @param settings The format of the file. Row predicates additionally filter the rows of the range.
+     */
+    [[nodiscard]] tl::expected<CSVd, ReadError> read_range(const std::filesystem::path& path, std::string_view column, double min, double max, const Settings& settings = Settings());
+
+    /**
+     * @brief Same as `read_range` but selects the column by index, e.g. for files without a header
+     */
+    [[nodiscard]] tl::expected<CSVd, ReadError> read_range(const std::filesystem::path& path, size_t column, double min, double max, const Settings& settings = Settings());
+
+}// namespace csvd
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <string_view>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief Sort direction of a key column
+     */
+    enum class Order{
+        Ascending,
+        Descending,
+    };
+
+    /**
+     * @brief Returns the row permutation that sorts the table by the given key columns
+     *
+     * The first column is the primary key, ties are broken by the following columns.
+     * The sort is stable. Large tables are sorted with a parallel LSD radix sort on the
+     * bit patterns of the keys. NaN values are sorted behind `+inf` (or before `-inf` if negative).
+     *
+     * @param table The table to sort
+     * @param columns The names of the key columns
+     * @param orders The direction per key column. Missing entries default to `Order::Ascending`.
+     * @param parallel Controls the multi-threading of large tables
+     * @return `result[i]` is the row of the input that ends up at row `i`
+     * @throws std::out_of_range if a column name does not exist
+     */
+    [[nodiscard]] std::vector<size_t> sort_permutation(const CSVd& table, const std::vector<std::string_view>& columns, const std::vector<Order>& orders = {}, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Sorts all columns of the table by the given key columns
+     *
+     * Only as many rows as the smallest column has are sorted, the remaining rows
+     * of longer columns stay at the end. See `sort_permutation` for the order.
+     *
+     * \code{.cpp}
+     * csvd::sort_by(csv, {"Time", "Channel"}, {csvd::Order::Ascending, csvd::Order::Descending});
+     * \endcode
+     *
+     * @throws std::out_of_range if a column name does not exist
+     */
+    void sort_by(CSVd& table, const std::vector<std::string_view>& columns, const std::vector<Order>& orders = {}, const ParallelSettings& parallel = ParallelSettings());
+
+    /**
+     * @brief Reorders the first `permutation.size()` rows of every column
+     *
+     * After the call row `i` holds the former row `permutation[i]`.
+     * Columns with fewer rows than the permutation are left unchanged.
+     */
+    void apply_permutation(CSVd& table, const std::vector<size_t>& permutation, const ParallelSettings& parallel = ParallelSettings());
+
+}// namespace csvd
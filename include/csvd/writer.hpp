@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <span>
+#include <ostream>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd{
+
+    /**
+     * @brief Streaming CSV writer that writes one row at a time
+     *
+     * Numbers are formatted with `std::to_chars` into an internal buffer that is written to the
+     * stream in large blocks. The output is identical to `stream << value`: the floating-point
+     * format and the precision of the stream are captured on construction. Streams with other
+     * formatting flags (width, `showpos`, a non-classic locale, ...) are written through the stream itself.
+     * `CSVd::write` is built on top of this writer.
+     *
+     * \code{.cpp}
+     * csvd::Writer writer(stream, settings);
+     * writer.write_header({"Time", "Voltage"});
+     * writer.write_row(std::array{0.0, 1.5});
+     * \endcode
+     */
+    class Writer{
+        public:
+
+            /**
+             * @brief Creates a writer on the stream. The stream has to outlive the writer.
+             */
+            explicit Writer(std::ostream& stream, Settings settings = Settings());
+
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+
+            /**
+             * @brief Flushes the remaining buffer into the stream
+             */
+            ~Writer();
+
+            /**
+             * @brief Writes the header line according to `Settings::header_type`
+             *
+             * `HeaderType::Auto` writes a header if any name is not empty. Empty names are replaced by quoted column numbers.
+             */
+            void write_header(const std::vector<std::string>& names);
+
+            /**
+             * @brief Writes one data row
+             */
+            void write_row(std::span<const double> values);
+
+            /**
+             * @brief Writes one row of cells as they are, without converting them
+             *
+             * Cells that contain a value or line separator of the output are quoted, unless they already are.
+             */
+            void write_row(std::span<const std::string_view> cells);
+
+            /**
+             * @brief Writes the buffer into the stream
+             */
+            void flush();
+
+            [[nodiscard]] inline const Settings& settings() const {return this->settings_;}
+
+        private:
+            void append(std::string_view text);
+            void append(char character);
+            void append(double value);
+            void end_cell(bool is_last);
+
+            std::ostream& stream_;
+            Settings settings_;
+            std::string buffer_;
+            std::array<bool, 256> is_separator_{};   ///< Value and line separators, cells that contain them are quoted
+            bool through_stream_ = false;   ///< Set if `to_chars` cannot reproduce the formatting of the stream
+            bool use_precision_ = true;     ///< `false` for hexadecimal floats, which are written with full precision
+            std::chars_format format_ = std::chars_format::general;
+            int precision_ = 6;
+    };
+
+}// namespace csvd
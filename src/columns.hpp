@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <csvd/csvd.hpp>
+
+namespace csvd::detail{
+
+    /**
+     * @brief Returns the index of the column with the name or throws `std::out_of_range`
+     */
+    [[nodiscard]] inline size_t column_index(const CSVd& table, std::string_view name){
+        const auto column = table.find(name);
+        if(column == table.end()){
+            throw std::out_of_range("csvd: no column named '" + std::string(name) + "'");
+        }
+        return static_cast<size_t>(std::distance(table.begin(), column));
+    }
+
+    /**
+     * @brief Returns the column with the name or throws `std::out_of_range`
+     */
+    [[nodiscard]] inline const Column& column_by_name(const CSVd& table, std::string_view name){
+        return table[column_index(table, name)];
+    }
+
+    /**
+     * @brief Returns the number of complete rows, which is the size of the smallest column
+     */
+    [[nodiscard]] inline size_t row_count(const CSVd& table){
+        size_t rows = table.empty() ? 0 : std::numeric_limits<size_t>::max();
+        for(const Column& column : table){
+            rows = std::min(rows, column.data.size());
+        }
+        return rows;
+    }
+
+    /**
+     * @brief Maps a double onto an unsigned integer with the same order
+     *
+     * Positive numbers get the sign bit set, negative numbers are inverted,
+     * so that the unsigned comparison of the keys matches the order of the values.
+     * `-0.0` and `0.0` get the same key because they compare equal.
+     */
+    [[nodiscard]] inline std::uint64_t order_key(double value){
+        const std::uint64_t bits = std::bit_cast<std::uint64_t>(value + 0.0);
+        return (bits >> 63) ? ~bits : (bits | (std::uint64_t(1) << 63));
+    }
+
+}// namespace csvd::detail
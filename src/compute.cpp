@@ -0,0 +1,308 @@
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#include <csvd/compute.hpp>
+
+#include "parallel.hpp"
+
+namespace csvd{
+
+    namespace {
+
+        constexpr size_t no_index = std::numeric_limits<size_t>::max();
+
+        /**
+         * @brief Compensated (Kahan-Babuska/Neumaier) sum, kept separately for every lane
+         */
+        struct CompensatedLanes{
+            double sum[detail::lanes] = {};
+            double compensation[detail::lanes] = {};
+        };
+
+        CSVD_TARGET_CLONES
+        void compensated_kernel(const double* values, size_t count, CompensatedLanes& state){
+            double sum[detail::lanes];
+            double compensation[detail::lanes];
+            for(size_t l = 0; l < detail::lanes; ++l){
+                sum[l] = state.sum[l];
+                compensation[l] = state.compensation[l];
+            }
+
+            size_t i = 0;
+            for(; i + detail::lanes <= count; i += detail::lanes){
+                for(size_t l = 0; l < detail::lanes; ++l){
+                    const double value = values[i + l];
+                    const double t = sum[l] + value;
+                    compensation[l] += (std::abs(sum[l]) >= std::abs(value)) ? ((sum[l] - t) + value) : ((value - t) + sum[l]);
+                    sum[l] = t;
+                }
+            }
+            for(size_t l = 0; i < count; ++i, ++l){
+                const double value = values[i];
+                const double t = sum[l] + value;
+                compensation[l] += (std::abs(sum[l]) >= std::abs(value)) ? ((sum[l] - t) + value) : ((value - t) + sum[l]);
+                sum[l] = t;
+            }
+
+            for(size_t l = 0; l < detail::lanes; ++l){
+                state.sum[l] = sum[l];
+                state.compensation[l] = compensation[l];
+            }
+        }
+
+        CSVD_TARGET_CLONES
+        double dot_kernel(const double* a, const double* b, size_t count){
+            double sum[detail::lanes] = {};
+            size_t i = 0;
+            for(; i + detail::lanes <= count; i += detail::lanes){
+                for(size_t l = 0; l < detail::lanes; ++l){
+                    sum[l] += a[i + l] * b[i + l];
+                }
+            }
+            for(size_t l = 0; i < count; ++i, ++l){
+                sum[l] += a[i] * b[i];
+            }
+            double result = 0;
+            for(size_t l = 0; l < detail::lanes; ++l){
+                result += sum[l];
+            }
+            return result;
+        }
+
+        CSVD_TARGET_CLONES
+        double min_kernel(const double* values, size_t count){
+            double result[detail::lanes];
+            for(size_t l = 0; l < detail::lanes; ++l){
+                result[l] = std::numeric_limits<double>::infinity();
+            }
+            size_t i = 0;
+            for(; i + detail::lanes <= count; i += detail::lanes){
+                for(size_t l = 0; l < detail::lanes; ++l){
+                    result[l] = (values[i + l] < result[l]) ? values[i + l] : result[l];
+                }
+            }
+            for(size_t l = 0; i < count; ++i, ++l){
+                result[l] = (values[i] < result[l]) ? values[i] : result[l];
+            }
+            for(size_t l = 1; l < detail::lanes; ++l){
+                result[0] = (result[l] < result[0]) ? result[l] : result[0];
+            }
+            return result[0];
+        }
+
+        CSVD_TARGET_CLONES
+        double max_kernel(const double* values, size_t count){
+            double result[detail::lanes];
+            for(size_t l = 0; l < detail::lanes; ++l){
+                result[l] = -std::numeric_limits<double>::infinity();
+            }
+            size_t i = 0;
+            for(; i + detail::lanes <= count; i += detail::lanes){
+                for(size_t l = 0; l < detail::lanes; ++l){
+                    result[l] = (values[i + l] > result[l]) ? values[i + l] : result[l];
+                }
+            }
+            for(size_t l = 0; i < count; ++i, ++l){
+                result[l] = (values[i] > result[l]) ? values[i] : result[l];
+            }
+            for(size_t l = 1; l < detail::lanes; ++l){
+                result[0] = (result[l] > result[0]) ? result[l] : result[0];
+            }
+            return result[0];
+        }
+
+        CSVD_TARGET_CLONES
+        double squared_deviation_kernel(const double* values, size_t count, double mean){
+            double sum[detail::lanes] = {};
+            size_t i = 0;
+            for(; i + detail::lanes <= count; i += detail::lanes){
+                for(size_t l = 0; l < detail::lanes; ++l){
+                    const double delta = values[i + l] - mean;
+                    sum[l] += delta * delta;
+                }
+            }
+            for(size_t l = 0; i < count; ++i, ++l){
+                const double delta = values[i] - mean;
+                sum[l] += delta * delta;
+            }
+            double result = 0;
+            for(size_t l = 0; l < detail::lanes; ++l){
+                result += sum[l];
+            }
+            return result;
+        }
+
+        /**
+         * @brief Returns the first position of `value` in `values` or `no_index`
+         */
+        size_t locate(const double* values, size_t count, double value){
+            for(size_t i = 0; i < count; ++i){
+                if(values[i] == value){
+                    return i;
+                }
+            }
+            return no_index;
+        }
+
+        /**
+         * @brief Searches the minimum or maximum in `[first, last)`, depending on `Max`
+         */
+        template<bool Max>
+        Extremum extremum(const std::deque<double>& data, size_t first, size_t last){
+            Extremum best;
+            detail::for_each_block(data, first, last, [&](const double* values, size_t count, size_t offset){
+                const double candidate = Max ? max_kernel(values, count) : min_kernel(values, count);
+                const bool better = Max ? (candidate > best.value) : (candidate < best.value);
+                if(best.index == no_index || better){
+                    const size_t position = locate(values, count, candidate);
+                    if(position != no_index){
+                        best.value = candidate;
+                        best.index = offset + position;
+                    }
+                }
+            });
+            return best;
+        }
+
+        template<bool Max>
+        Extremum parallel_extremum(const Column& column, const ParallelSettings& parallel){
+            const size_t n = column.data.size();
+            const unsigned int threads = detail::thread_count(n, parallel);
+            std::vector<Extremum> partials(threads);
+            detail::parallel_for(n, threads, [&](unsigned int part, size_t first, size_t last){
+                partials[part] = extremum<Max>(column.data, first, last);
+            });
+
+            // combine in order so that the first occurrence wins
+            Extremum best;
+            for(const Extremum& partial : partials){
+                if(partial.index == no_index) continue;
+                const bool better = Max ? (partial.value > best.value) : (partial.value < best.value);
+                if(best.index == no_index || better){
+                    best = partial;
+                }
+            }
+            return best;
+        }
+
+        double naive_sum(const std::deque<double>& data, size_t first, size_t last){
+            double result = 0;
+            for(size_t i = first; i < last; ++i){
+                result += data[i];
+            }
+            return result;
+        }
+
+    }// namespace
+
+    double sum(const Column& column, const ParallelSettings& parallel){
+        const size_t n = column.data.size();
+        const unsigned int threads = detail::thread_count(n, parallel);
+        std::vector<CompensatedLanes> partials(threads);
+        detail::parallel_for(n, threads, [&](unsigned int part, size_t first, size_t last){
+            detail::for_each_block(column.data, first, last, [&](const double* values, size_t count, size_t){
+                compensated_kernel(values, count, partials[part]);
+            });
+        });
+
+        detail::NeumaierSum result;
+        for(const CompensatedLanes& partial : partials){
+            for(size_t l = 0; l < detail::lanes; ++l){
+                result.add(partial.sum[l]);
+                result.add(partial.compensation[l]);
+            }
+        }
+
+        // compensation turns infinities into NaN, fall back to the plain sum to get the correct sign
+        if(std::isnan(result.result())){
+            return naive_sum(column.data, 0, n);
+        }
+        return result.result();
+    }
+
+    double mean(const Column& column, const ParallelSettings& parallel){
+        if(column.data.empty()){
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return sum(column, parallel) / static_cast<double>(column.data.size());
+    }
+
+    Extremum minimum(const Column& column, const ParallelSettings& parallel){
+        return parallel_extremum<false>(column, parallel);
+    }
+
+    Extremum maximum(const Column& column, const ParallelSettings& parallel){
+        return parallel_extremum<true>(column, parallel);
+    }
+
+    double dot(const Column& a, const Column& b, const ParallelSettings& parallel){
+        const size_t n = std::min(a.data.size(), b.data.size());
+        const unsigned int threads = detail::thread_count(n, parallel);
+        std::vector<detail::NeumaierSum> partials(threads);
+        detail::parallel_for(n, threads, [&](unsigned int part, size_t first, size_t last){
+            detail::for_each_block(a.data, b.data, first, last, [&](const double* values_a, const double* values_b, size_t count, size_t){
+                partials[part].add(dot_kernel(values_a, values_b, count));
+            });
+        });
+
+        detail::NeumaierSum result;
+        for(const detail::NeumaierSum& partial : partials){
+            result.add(partial.result());
+        }
+        return result.result();
+    }
+
+    double norm(const Column& column, const ParallelSettings& parallel){
+        const size_t n = column.data.size();
+        const unsigned int threads = detail::thread_count(n, parallel);
+        std::vector<detail::NeumaierSum> partials(threads);
+        detail::parallel_for(n, threads, [&](unsigned int part, size_t first, size_t last){
+            detail::for_each_block(column.data, first, last, [&](const double* values, size_t count, size_t){
+                partials[part].add(dot_kernel(values, values, count));
+            });
+        });
+
+        detail::NeumaierSum result;
+        for(const detail::NeumaierSum& partial : partials){
+            result.add(partial.result());
+        }
+        return std::sqrt(result.result());
+    }
+
+    double variance(const Column& column, const ParallelSettings& parallel){
+        return statistics(column, parallel).variance();
+    }
+
+    Statistics statistics(const Column& column, const ParallelSettings& parallel){
+        const size_t n = column.data.size();
+        const unsigned int threads = detail::thread_count(n, parallel);
+        std::vector<Statistics> partials(threads);
+        detail::parallel_for(n, threads, [&](unsigned int part, size_t first, size_t last){
+            detail::for_each_block(column.data, first, last, [&](const double* values, size_t count, size_t){
+                // two passes over the cached block, then merge into the running result
+                CompensatedLanes lanes;
+                compensated_kernel(values, count, lanes);
+                double block_sum = 0;
+                for(size_t l = 0; l < detail::lanes; ++l){
+                    block_sum += lanes.sum[l] + lanes.compensation[l];
+                }
+
+                Statistics block;
+                block.count = count;
+                block.mean = block_sum / static_cast<double>(count);
+                block.m2 = squared_deviation_kernel(values, count, block.mean);
+                block.min = min_kernel(values, count);
+                block.max = max_kernel(values, count);
+                partials[part].merge(block);
+            });
+        });
+
+        Statistics result;
+        for(const Statistics& partial : partials){
+            result.merge(partial);
+        }
+        return result;
+    }
+
+}// namespace csvd
@@ -4,6 +4,10 @@
 #include <charconv>
 #include <limits>
 #include <csvd/csvd.hpp>
+#include <csvd/reader.hpp>
+#include <csvd/writer.hpp>
+
+#include "stats.hpp"
 
 #include <tl/expected.hpp>
 
@@ -161,6 +165,7 @@ namespace csvd{
         stream << "Error parsing csv\n";
         stream << "  column: " << (this->col()+1) << '\n';
         stream << "  row: " << (this->row()+1) << '\n';
+        stream << "  byte: " << this->offset() << " (line at byte " << this->line_offset() << ")\n";
         const std::string_view cell_content = this->cell();
         stream << "  cell: " << cell_content;
         if(cell_content.size() == this->cell_.size()){
@@ -216,6 +221,12 @@ namespace csvd{
             break; case ErrorCase::CellTooLong :{
                 stream << "Cell is too long and contains more than 128 characters. Note that this library does only support cells with a maximum length of 128 characters.";
             }
+            break; case ErrorCase::UnknownColumn :{
+                stream << "Unknown column '" << this->cell() << "'.";
+            }
+            break; case ErrorCase::Cancelled :{
+                stream << "The read has been cancelled.";
+            }
             break; default: {
                 stream << "No error message for this error. This is an internal error. Please write an issue to the developers.";
             }
@@ -225,85 +236,49 @@ namespace csvd{
         stream.flush();
     }
 
-    /**
-     * @brief Reads characters from the string until a delimiter has been found
-     * 
-     * Will not read the delimiter from the stream. So the next character in the stream
-     * will be the delimiter or the end of the stream.
-     * 
-     * @param stream A reference to the stream object
-     * @return A string containing all characters until the delimiter
-     */
-    std::optional<std::string_view> CSVd::read_cell(char* buffer_first, size_t buffer_size, std::istream& stream){
-        char * itr = buffer_first;
-        char * buffer_last = buffer_first + buffer_size;
-        bool is_in_quote = false;
-        while(stream.eof() == false){
-            if(itr == buffer_last){
-                return std::nullopt;
-            }
-            bool has_quote = std::ranges::contains(this->settings_.quotes, stream.peek());
-
-            // toggle being in quotes
-            if(is_in_quote){
-                if(has_quote){
-                    is_in_quote = false;
-                }
-            }else{
-                if(has_quote){
-                    is_in_quote = true;
-                }
-            }
-
-            
-            bool has_value_separator = std::ranges::contains(this->settings_.value_separators, stream.peek());
-            bool has_line_separator = std::ranges::contains(this->settings_.line_separators, stream.peek());
-            
-            // ignore value separator if in quotes
-            if(is_in_quote){
-                has_value_separator = false;
-            }
-
-            // break on separators
-            if(has_value_separator || has_line_separator){
-                break;
-            }
-
-            //Append characters
-            *itr = stream.get();
-            ++itr;
+    void Column::enable_statistics(){
+        Statistics stats;
+        for(const double value : this->data){
+            stats.push(value);
         }
-        return std::string_view(buffer_first, itr);
+        this->statistics = stats;
     }
 
-    static void skip(std::istream& stream, std::string_view skip){
-        while((stream.eof() == false) && (stream.bad() == false) && (std::ranges::contains(skip, stream.peek()))){
-            (void)stream.ignore(); // consume
+    void Column::update_sortedness(){
+        this->sortedness = Sortedness::Constant;
+        for(size_t i = 1; i < this->data.size() && this->sortedness != Sortedness::Unsorted; ++i){
+            this->sortedness = next_sortedness(this->sortedness, this->data[i - 1], this->data[i]);
         }
+        this->sorted_rows = this->data.size();
     }
 
-    static void skip_whitespaces(std::istream& stream){
-        const std::string_view whitespaces(" \a\b\t\n\v\f\r");
-        skip(stream, whitespaces);
+    Sortedness Column::order() const {
+        if(this->has_sortedness()){
+            return this->sortedness;
+        }
+        Sortedness result = Sortedness::Constant;
+        for(size_t i = 1; i < this->data.size() && result != Sortedness::Unsorted; ++i){
+            result = next_sortedness(result, this->data[i - 1], this->data[i]);
+        }
+        return result;
     }
 
-    [[nodiscard]] static std::string_view trim(std::string_view string, std::string_view trim_chars){
-        const std::string::size_type pos1 = string.find_first_not_of(trim_chars);
-        const std::string::size_type pos2 = string.find_last_not_of(trim_chars);
-        const std::string::size_type count = pos2 - pos1 + 1;
-        
-        if(pos1 == std::string_view::npos){
-            return std::string_view("", 0);
-        }else if(pos2 == std::string::npos){
-            return string.substr(pos1);
-        }else{
-            return string.substr(pos1, count);
+    void Column::update_zones(){
+        this->zones.assign((this->data.size() + zone_size - 1) / zone_size, Zone());
+        size_t row = 0;
+        for(const double value : this->data){
+            this->zones[row / zone_size].push(value);
+            ++row;
         }
     }
 
-    [[nodiscard]] static std::string_view trim_whitespaces(std::string_view string){
-        const std::string_view whitespaces(" \a\b\t\n\v\f\r");
-        return trim(string, whitespaces);
+    Column Column::clone_empty() const {
+        Column result;
+        result.name = this->name;
+        if(this->statistics.has_value()){
+            result.statistics.emplace();
+        }
+        return result;
     }
 
     void CSVd::set_header_type(HeaderType header) {
@@ -402,200 +377,84 @@ namespace csvd{
         return this->end();
     }
 
-    tl::expected<void, ReadError> CSVd::read(std::istream& stream){
-        if(stream.eof()){
-            return tl::unexpected(ReadError(ErrorCase::UnexpectedEof, "", {'\0'}, 0, 0, '\0'));
-        }
-        if(stream.bad()){
-            return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, 0, 0, '\0'));
-        }
-        
-        // read data
-        int column = 0;
-        int row = 0;
+    tl::expected<void, ReadError> CSVd::read(std::istream& stream, ReadStats* stats){
+        return this->read(stream, ReadControl(), stats);
+    }
 
+    tl::expected<void, ReadError> CSVd::read(std::istream& stream, const ReadControl& control, ReadStats* stats){
         this->clear();
-        
-        HeaderType header_type = this->settings_.header_type;
-
-        if(header_type == HeaderType::Auto) {
-            skip_whitespaces(stream);
-            if(std::isdigit(stream.peek()) || stream.peek() == '+' || stream.peek() == '-'){
-                // detected numeric data in the first row --> no header
-                header_type = HeaderType::None;
-            }else{
-                // detected non-numeric string in the first row --> has header
-                header_type = HeaderType::FirstRow;
-            }
-        }
 
-        // read header
-        if(header_type == HeaderType::FirstRow){
-            tl::expected<void, ReadError> result = this->read_with_header(stream);
-            if(result.has_value() == false){
-                return result;
+        Reader reader(stream, this->settings_);
+        reader.set_control(control);
+        // the buffers and the columns only grow while reading, so the footprint is recorded once at the end, also on errors
+        const auto record_memory = [&]{
+            if constexpr (detail::stats_enabled){
+                if(stats != nullptr){
+                    size_t memory = reader.memory();
+                    for(const Column& column : this->columns_){
+                        memory += column.data.size() * sizeof(double) + column.zones.capacity() * sizeof(Zone);
+                    }
+                    stats->memory = std::max(stats->memory, memory);
+                }
             }
-            ++row;
-        }else{
-            tl::expected<void, ReadError> result = this->read_without_header(stream);
+        };
+        if constexpr (detail::stats_enabled){
+            reader.set_stats(stats);
+        }
+        {
+            tl::expected<void, ReadError> result = reader.read_header();
             if(result.has_value() == false){
+                record_memory();
                 return result;
             }
-            ++row;
-        }
-
-        // read data
-        while((stream.eof() == false)){
-
-            if(stream.bad()){
-                return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, column, row, '\0'));
-            }
-            
-            skip_whitespaces(stream);
-
-            // check for eof after new line
-            if(stream.eof()){
-                if(column == 0){
-                    // eof after new colum --> probably last empty line --> ok
-                    break;
-                }else{
-                    return tl::unexpected(ReadError(ErrorCase::UnexpectedEof, "", {'\0'}, column, row, '\0'));
-                }
-            }
-
-            char buffer[128];
-            std::optional<std::string_view> opt_cell = read_cell(buffer, sizeof(buffer) / sizeof(char), stream);
-            if(opt_cell.has_value() == false){
-                return tl::unexpected(ReadError(ErrorCase::CellTooLong, "", {'\0'}, column, row, stream.peek()));
-            }
-            std::string_view cell = trim_whitespaces(opt_cell.value());
-            
-            double value = 0;
-            {
-                const std::from_chars_result result = std::from_chars(cell.data(), cell.data() + cell.size(), value);
-                if(result.ec != std::errc{}){
-                    return tl::unexpected(ReadError(ErrorCase::ErrorParsingFloat, cell, {'\0'}, column, row, stream.peek()));
-                }
-            }
-
-            if(column < this->size()){
-                this->at(column).data.emplace_back(value);
-            }else{
-                return tl::unexpected(ReadError(ErrorCase::CellOutOfRange, cell, {'\0'}, column, row, stream.peek()));
-            }
-
-            if(std::ranges::contains(this->settings_.line_separators, stream.peek()) || stream.eof()){
-                if(column+1 != this->size()){
-                    return tl::unexpected(
-                        ReadError(ErrorCase::UnexpectedLineSeparator, cell, this->settings_.line_separators, column, row, stream.eof() ? '\0' : stream.peek()));
-                }
-                column = 0;
-                ++row;
-            }else{
-                if(column+1 == this->size()){
-                    return tl::unexpected(ReadError(ErrorCase::ExpectedLineSeparator, cell, this->settings_.line_separators, column, row, stream.peek()));
-                }
-
-                if(!std::ranges::contains(this->settings_.value_separators, stream.peek())){
-                    return tl::unexpected(ReadError(ErrorCase::ExpectedValueSeparator, cell, this->settings_.value_separators, column, row, stream.peek()));
-                }
-                ++column;
-            }
-
-            // consume the delimiter
-            stream.ignore();
         }
-        return {};
-    }
-
-    tl::expected<void, ReadError> CSVd::read_with_header(std::istream& stream){
-        // read header names
-        size_t column_index = 0;
-        while(stream.eof() == false){
-
-            if(stream.bad()){
-                return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, column_index, 0, '\0'));
-            }
 
-            // parse cell
-            char buffer[128];
-            std::optional<std::string_view> opt_cell = read_cell(buffer, sizeof(buffer) / sizeof(char), stream);
-            if(opt_cell.has_value() == false){
-                return tl::unexpected(ReadError(ErrorCase::CellTooLong, "", {'\0'}, column_index, 0, stream.peek()));
-            }
-            std::string_view cell = trim_whitespaces(opt_cell.value());
-            if(this->settings_.auto_quotes){
-                cell = trim(cell, this->quotes());
-            }
-            
-            // create new column
+        // create columns
+        for(const std::string& name : reader.names()){
             Column column;
-            column.name = cell;
-            this->push_back(std::move(column));
-
-            // check if the line has ended
-            const bool has_line_separator = std::ranges::contains(this->settings_.line_separators, stream.peek());
-            
-            // consume delimiter
-            stream.ignore();
-
-            // break if the line has ended
-            if(has_line_separator){
-                break;
+            column.name = name;
+            if(this->settings_.compute_statistics){
+                column.statistics.emplace();
             }
-
-            ++column_index;
+            this->push_back(std::move(column));
         }
 
-        return {};
-    }
-
-    tl::expected<void, ReadError> CSVd::read_without_header(std::istream& stream){
-        // read first line and allocate columns
-        size_t column_index = 0;
-        while(stream.eof() == false){
-
-            if(stream.bad()){
-                return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, column_index, 0, '\0'));;
+        // read data
+        while(true){
+            tl::expected<bool, ReadError> result = reader.next_row();
+            if(result.has_value() == false){
+                this->errors_ = reader.errors();
+                record_memory();
+                return tl::unexpected(result.error());
             }
-
-            char buffer[128];
-            std::optional<std::string_view> opt_cell = read_cell(buffer, sizeof(buffer) / sizeof(char), stream);
-            if(opt_cell.has_value() == false){
-                return tl::unexpected(ReadError(ErrorCase::CellTooLong, "", {'\0'}, column_index, 0, stream.peek()));
+            if(result.value() == false){
+                break;
             }
-            std::string_view cell = trim_whitespaces(opt_cell.value());
 
-            if(this->settings_.auto_quotes){
-                cell = trim(cell, this->quotes());
-            }
-            
-            Column column;
-            double value = 0;
-            {
-                const std::from_chars_result result = std::from_chars(cell.data(), cell.data() + cell.size(), value);
-                if(result.ec != std::errc{}){
-                    return tl::unexpected(ReadError(ErrorCase::ErrorParsingFloat, cell, {'\0'}, column_index, 0, stream.peek()));;
+            const std::span<const double> values = reader.values();
+            if constexpr (detail::stats_enabled){
+                if(stats != nullptr){
+                    const auto start = detail::stats_now();
+                    for(size_t column = 0; column < values.size(); ++column){
+                        const ColumnData& data = this->columns_[column].data;
+                        const double* previous = data.empty() ? nullptr : &data.back();
+                        this->columns_[column].push_back(values[column]);
+                        // the deque allocates a new block whenever the values stop being contiguous
+                        if(previous == nullptr || &data.back() != previous + 1){
+                            ++stats->allocations;
+                        }
+                    }
+                    stats->append += detail::stats_now() - start;
+                    continue;
                 }
             }
-
-            column.data.emplace_back(value);
-            this->push_back(std::move(column));
-
-            // check if the line has ended
-            const bool has_line_separator = std::ranges::contains(this->settings_.line_separators, stream.peek());
-            
-            // consume delimiter
-            stream.ignore();
-
-            // break if the line has ended
-            if(has_line_separator){
-                break;
+            for(size_t column = 0; column < values.size(); ++column){
+                this->columns_[column].push_back(values[column]);
             }
-
-            ++column_index;
         }
 
+        record_memory();
+        this->errors_ = reader.errors();
         return {};
     }
 
@@ -605,56 +464,13 @@ namespace csvd{
             return;
         }
 
-        HeaderType header_type = this->settings_.header_type;
+        Writer writer(stream, this->settings_);
 
-        if(header_type == HeaderType::Auto){
-            header_type = HeaderType::None;
-            for(const csvd::Column& col : *this){
-                if(col.name.empty() == false){
-                    header_type = HeaderType::FirstRow;
-                    break;
-                }
-            }
-        }
-
-        // print header
-        if(header_type == HeaderType::FirstRow){
-            auto col_itr = this->begin();
-            size_t index = 0;
-            while(col_itr != this->end()){
-                if(this->settings_.auto_quotes){
-                    stream << this->settings_.quotes[0]; // quotes is guaranteed to not be empty
-                }
-
-                if(col_itr->name.empty() == false){
-                    stream << col_itr->name;
-                }else{
-                    // print column number in quotes
-                    if(this->settings_.auto_quotes == false){
-                        stream << this->settings_.quotes[0]; // quotes is guaranteed to not be empty
-                    }
-                    stream << index;
-                    if(this->settings_.auto_quotes == false){
-                        stream << this->settings_.quotes[0]; // quotes is guaranteed to not be empty
-                    }
-                }
-
-                if(this->settings_.auto_quotes){
-                    stream << this->settings_.quotes[0]; // quotes is guaranteed to not be empty
-                }
-
-                ++col_itr;
-                ++index;
-
-                if(col_itr == this->end()){
-                    // end of line
-                    stream << this->settings_.line_separators[0]; // line separator is guaranteed to not be empty
-                }else{
-                    // end of cell
-                    stream << this->settings_.value_separators[0]; // value_separators is guaranteed to not be empty
-                }
-            }
+        std::vector<std::string> names;
+        for(const csvd::Column& col : *this){
+            names.push_back(col.name);
         }
+        writer.write_header(names);
 
         // get the smallest data vector size
         size_t min_data_length = std::numeric_limits<size_t>::max();
@@ -663,25 +479,26 @@ namespace csvd{
         }
 
         // print data
-        for(size_t row = 0; row < min_data_length; ++row){
-            auto col_itr = this->begin();
-            while(col_itr != this->end()){
-                stream << col_itr->data[row];
-                ++col_itr;
-                if(col_itr == this->end()){
-                    // end of line
-                    stream << this->settings_.line_separators[0]; // line separator is guaranteed to not be empty
-                }else{
-                    // end of cell
-                    stream << this->settings_.value_separators[0]; // value_separators is guaranteed to not be empty
-                }
+        std::vector<std::deque<double>::const_iterator> iterators;
+        for(const csvd::Column& col : *this){
+            iterators.push_back(col.data.begin());
+        }
+        std::vector<double> row(this->size());
+        for(size_t r = 0; r < min_data_length; ++r){
+            for(size_t c = 0; c < iterators.size(); ++c){
+                row[c] = *iterators[c]++;
             }
+            writer.write_row(row);
         }
     }
 
-    tl::expected<CSVd, ReadError> read(std::istream& stream, Settings settings){
+    tl::expected<CSVd, ReadError> read(std::istream& stream, Settings settings, ReadStats* stats){
+        return read(stream, std::move(settings), ReadControl(), stats);
+    }
+
+    tl::expected<CSVd, ReadError> read(std::istream& stream, Settings settings, const ReadControl& control, ReadStats* stats){
         CSVd csv(settings);
-        tl::expected<void, ReadError> r = csv.read(stream);
+        tl::expected<void, ReadError> r = csv.read(stream, control, stats);
         if(r.has_value()){
             return csv;
         }else{
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <fstream>
+
+#include <csvd/diagnostics.hpp>
+
+namespace csvd{
+
+    namespace {
+
+        /// The longest line that is returned, longer lines are cut around the failing cell
+        constexpr std::uint64_t max_context_length = 1024;
+
+        /**
+         * @brief Returns the bytes of the source that `make_context` needs
+         */
+        struct Window{
+            std::uint64_t first;
+            std::uint64_t last;
+        };
+
+        [[nodiscard]] Window window(const ReadError& error, std::uint64_t size){
+            const std::uint64_t first = std::min(std::max(error.line_offset(), (error.offset() > max_context_length / 2) ? error.offset() - max_context_length / 2 : 0), size);
+            return Window{first, std::min(first + max_context_length, size)};
+        }
+
+        /**
+         * @brief Cuts the line of the error out of the bytes that start at `offset`
+         */
+        [[nodiscard]] ErrorContext make_context(std::string_view bytes, std::uint64_t offset, const ReadError& error, const Settings& settings){
+            const std::string_view line_separators(settings.line_separators.data(), static_cast<size_t>(std::ranges::find(settings.line_separators, '\0') - settings.line_separators.begin()));
+            std::string_view line = bytes.substr(0, bytes.find_first_of(line_separators));
+            if(line.empty() == false && line.back() == '\r'){
+                line.remove_suffix(1);
+            }
+            ErrorContext context;
+            context.line = line;
+            context.line_offset = offset;
+            context.position = static_cast<size_t>(std::min<std::uint64_t>(error.offset() - std::min(error.offset(), offset), line.size()));
+            return context;
+        }
+
+    }// namespace
+
+    std::ostream& operator<<(std::ostream& stream, const ErrorContext& context){
+        stream << context.line << '\n';
+        // keep tabs, so the marker lines up with the cell
+        for(size_t i = 0; i < context.position && i < context.line.size(); ++i){
+            stream << ((context.line[i] == '\t') ? '\t' : ' ');
+        }
+        return stream << '^';
+    }
+
+    ErrorContext error_context(std::string_view buffer, const ReadError& error, const Settings& settings){
+        const Window bytes = window(error, buffer.size());
+        return make_context(buffer.substr(static_cast<size_t>(bytes.first), static_cast<size_t>(bytes.last - bytes.first)), bytes.first, error, settings);
+    }
+
+    tl::expected<ErrorContext, ReadError> read_error_context(const std::filesystem::path& path, const ReadError& error, const Settings& settings){
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if(file.is_open() == false){
+            return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, 0, 0, '\0'));
+        }
+        const Window bytes = window(error, static_cast<std::uint64_t>(file.tellg()));
+        std::string text(static_cast<size_t>(bytes.last - bytes.first), '\0');
+        file.seekg(static_cast<std::streamoff>(bytes.first));
+        file.read(text.data(), static_cast<std::streamsize>(text.size()));
+        if(file.bad()){
+            return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, 0, 0, '\0'));
+        }
+        text.resize(static_cast<size_t>(file.gcount()));
+        return make_context(text, bytes.first, error, settings);
+    }
+
+}// namespace csvd
@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <csvd/expression.hpp>
+#include <csvd/writer.hpp>
+
+#include "parallel.hpp"
+#include "columns.hpp"
+#include "program.hpp"
+
+namespace csvd{
+
+    namespace detail{
+
+        namespace {
+
+            [[nodiscard]] size_t arity(Op op){
+                switch(op){
+                    case Op::Constant: case Op::Column: return 0;
+                    case Op::Negate: case Op::Not: case Op::Abs: case Op::Sqrt: case Op::Exp: case Op::Log: case Op::Log10:
+                    case Op::Sin: case Op::Cos: case Op::Tan: case Op::Atan: case Op::Floor: case Op::Ceil: case Op::IsNaN: return 1;
+                    case Op::Where: return 3;
+                    default: return 2;
+                }
+            }
+
+            /**
+             * @brief Runs one instruction on `count` values. Every case is a plain loop the compiler can vectorize.
+             */
+            CSVD_TARGET_CLONES
+            void execute(Op op, const double* a, const double* b, const double* c, size_t count, double* out){
+                switch(op){
+                    break; case Op::Negate: for(size_t i = 0; i < count; ++i) out[i] = -a[i];
+                    break; case Op::Not: for(size_t i = 0; i < count; ++i) out[i] = (a[i] == 0) ? 1.0 : 0.0;
+                    break; case Op::Abs: for(size_t i = 0; i < count; ++i) out[i] = std::abs(a[i]);
+                    break; case Op::Sqrt: for(size_t i = 0; i < count; ++i) out[i] = std::sqrt(a[i]);
+                    break; case Op::Exp: for(size_t i = 0; i < count; ++i) out[i] = std::exp(a[i]);
+                    break; case Op::Log: for(size_t i = 0; i < count; ++i) out[i] = std::log(a[i]);
+                    break; case Op::Log10: for(size_t i = 0; i < count; ++i) out[i] = std::log10(a[i]);
+                    break; case Op::Sin: for(size_t i = 0; i < count; ++i) out[i] = std::sin(a[i]);
+                    break; case Op::Cos: for(size_t i = 0; i < count; ++i) out[i] = std::cos(a[i]);
+                    break; case Op::Tan: for(size_t i = 0; i < count; ++i) out[i] = std::tan(a[i]);
+                    break; case Op::Atan: for(size_t i = 0; i < count; ++i) out[i] = std::atan(a[i]);
+                    break; case Op::Floor: for(size_t i = 0; i < count; ++i) out[i] = std::floor(a[i]);
+                    break; case Op::Ceil: for(size_t i = 0; i < count; ++i) out[i] = std::ceil(a[i]);
+                    break; case Op::IsNaN: for(size_t i = 0; i < count; ++i) out[i] = (a[i] != a[i]) ? 1.0 : 0.0;
+                    break; case Op::Add: for(size_t i = 0; i < count; ++i) out[i] = a[i] + b[i];
+                    break; case Op::Subtract: for(size_t i = 0; i < count; ++i) out[i] = a[i] - b[i];
+                    break; case Op::Multiply: for(size_t i = 0; i < count; ++i) out[i] = a[i] * b[i];
+                    break; case Op::Divide: for(size_t i = 0; i < count; ++i) out[i] = a[i] / b[i];
+                    break; case Op::Pow: for(size_t i = 0; i < count; ++i) out[i] = std::pow(a[i], b[i]);
+                    break; case Op::Atan2: for(size_t i = 0; i < count; ++i) out[i] = std::atan2(a[i], b[i]);
+                    break; case Op::Hypot: for(size_t i = 0; i < count; ++i) out[i] = std::hypot(a[i], b[i]);
+                    break; case Op::Min: for(size_t i = 0; i < count; ++i) out[i] = std::fmin(a[i], b[i]);
+                    break; case Op::Max: for(size_t i = 0; i < count; ++i) out[i] = std::fmax(a[i], b[i]);
+                    break; case Op::Less: for(size_t i = 0; i < count; ++i) out[i] = (a[i] < b[i]) ? 1.0 : 0.0;
+                    break; case Op::LessEqual: for(size_t i = 0; i < count; ++i) out[i] = (a[i] <= b[i]) ? 1.0 : 0.0;
+                    break; case Op::Greater: for(size_t i = 0; i < count; ++i) out[i] = (a[i] > b[i]) ? 1.0 : 0.0;
+                    break; case Op::GreaterEqual: for(size_t i = 0; i < count; ++i) out[i] = (a[i] >= b[i]) ? 1.0 : 0.0;
+                    break; case Op::Equal: for(size_t i = 0; i < count; ++i) out[i] = (a[i] == b[i]) ? 1.0 : 0.0;
+                    break; case Op::NotEqual: for(size_t i = 0; i < count; ++i) out[i] = (a[i] != b[i]) ? 1.0 : 0.0;
+                    break; case Op::And: for(size_t i = 0; i < count; ++i) out[i] = ((a[i] != 0) & (b[i] != 0)) ? 1.0 : 0.0;
+                    break; case Op::Or: for(size_t i = 0; i < count; ++i) out[i] = ((a[i] != 0) | (b[i] != 0)) ? 1.0 : 0.0;
+                    break; case Op::Where: for(size_t i = 0; i < count; ++i) out[i] = (a[i] != 0) ? b[i] : c[i];
+                    break; case Op::Constant: case Op::Column: {}
+                }
+            }
+
+        }// namespace
+
+        Program::Program(const Expr& expression, std::vector<std::string>& inputs){
+            std::vector<bool> used;
+            this->result_ = this->compile(*expression.node(), inputs, used);
+        }
+
+        Program::Operand Program::compile(const ExprNode& node, std::vector<std::string>& inputs, std::vector<bool>& used){
+            if(node.op == Op::Constant){
+                this->constants_.push_back(node.value);
+                return Operand{Operand::Kind::Constant, this->constants_.size() - 1};
+            }
+            if(node.op == Op::Column){
+                const auto found = std::ranges::find(inputs, node.name);
+                if(found != inputs.end()){
+                    return Operand{Operand::Kind::Input, static_cast<size_t>(found - inputs.begin())};
+                }
+                inputs.push_back(node.name);
+                return Operand{Operand::Kind::Input, inputs.size() - 1};
+            }
+
+            Instruction instruction;
+            instruction.op = node.op;
+            instruction.arguments.fill(Operand{Operand::Kind::Constant, 0});
+            const size_t n = arity(node.op);
+            for(size_t a = 0; a < n; ++a){
+                instruction.arguments[a] = this->compile(*node.children[a], inputs, used);
+            }
+
+            // the arguments are only read element-wise, so the output may reuse their registers
+            for(size_t a = 0; a < n; ++a){
+                if(instruction.arguments[a].kind == Operand::Kind::Register){
+                    used[instruction.arguments[a].index] = false;
+                }
+            }
+            const auto free = std::ranges::find(used, false);
+            instruction.output = static_cast<size_t>(free - used.begin());
+            if(free == used.end()){
+                used.push_back(true);
+            }else{
+                *free = true;
+            }
+            this->registers_ = std::max(this->registers_, used.size());
+
+            // constant arguments need at least one slot, even if unused
+            if(this->constants_.empty()){
+                this->constants_.push_back(0);
+            }
+            this->instructions_.push_back(instruction);
+            return Operand{Operand::Kind::Register, instruction.output};
+        }
+
+        std::vector<double> Program::scratch() const {
+            std::vector<double> scratch((this->registers_ + this->constants_.size()) * block_size);
+            for(size_t c = 0; c < this->constants_.size(); ++c){
+                const auto begin = scratch.begin() + static_cast<std::ptrdiff_t>((this->registers_ + c) * block_size);
+                std::fill(begin, begin + block_size, this->constants_[c]);
+            }
+            return scratch;
+        }
+
+        const double* Program::run(std::span<const double* const> inputs, size_t count, std::vector<double>& scratch) const {
+            const auto pointer = [&](const Operand& operand) -> const double* {
+                switch(operand.kind){
+                    case Operand::Kind::Input: return inputs[operand.index];
+                    case Operand::Kind::Register: return scratch.data() + operand.index * block_size;
+                    case Operand::Kind::Constant: return scratch.data() + (this->registers_ + operand.index) * block_size;
+                }
+                return nullptr;
+            };
+
+            for(const Instruction& instruction : this->instructions_){
+                execute(instruction.op, pointer(instruction.arguments[0]), pointer(instruction.arguments[1]), pointer(instruction.arguments[2]),
+                    count, scratch.data() + instruction.output * block_size);
+            }
+            return pointer(this->result_);
+        }
+
+    }// namespace detail
+
+    namespace {
+
+        using NodePointer = std::shared_ptr<const detail::ExprNode>;
+
+        [[nodiscard]] Expr make(detail::Op op, NodePointer a, NodePointer b = nullptr, NodePointer c = nullptr){
+            auto node = std::make_shared<detail::ExprNode>();
+            node->op = op;
+            node->children = {std::move(a), std::move(b), std::move(c)};
+            return Expr(std::move(node));
+        }
+
+        void collect_columns(const detail::ExprNode& node, std::vector<std::string>& names){
+            if(node.op == detail::Op::Column){
+                if(std::ranges::find(names, node.name) == names.end()){
+                    names.push_back(node.name);
+                }
+                return;
+            }
+            for(const NodePointer& child : node.children){
+                if(child){
+                    collect_columns(*child, names);
+                }
+            }
+        }
+
+        /**
+         * @brief Copies blocks of the input columns of programs into contiguous buffers
+         */
+        class BlockStaging{
+            public:
+                BlockStaging(const CSVd& table, const std::vector<std::string>& inputs)
+                    : buffer_(inputs.size() * detail::block_size)
+                    , pointers_(inputs.size())
+                {
+                    for(const std::string& name : inputs){
+                        this->columns_.push_back(&detail::column_by_name(table, name));
+                    }
+                }
+
+                /**
+                 * @brief The number of rows that all input columns have, `fallback` if there are no inputs
+                 */
+                [[nodiscard]] size_t rows(size_t fallback) const {
+                    if(this->columns_.empty()){
+                        return fallback;
+                    }
+                    size_t rows = std::numeric_limits<size_t>::max();
+                    for(const Column* column : this->columns_){
+                        rows = std::min(rows, column->data.size());
+                    }
+                    return rows;
+                }
+
+                [[nodiscard]] std::span<const double* const> load(size_t offset, size_t count){
+                    for(size_t c = 0; c < this->columns_.size(); ++c){
+                        const auto begin = this->columns_[c]->data.begin() + static_cast<std::ptrdiff_t>(offset);
+                        double* destination = this->buffer_.data() + c * detail::block_size;
+                        std::copy(begin, begin + static_cast<std::ptrdiff_t>(count), destination);
+                        this->pointers_[c] = destination;
+                    }
+                    return this->pointers_;
+                }
+
+            private:
+                std::vector<const Column*> columns_;
+                std::vector<double> buffer_;
+                std::vector<const double*> pointers_;
+        };
+
+    }// namespace
+
+    Expr::Expr(double value){
+        auto node = std::make_shared<detail::ExprNode>();
+        node->op = detail::Op::Constant;
+        node->value = value;
+        this->node_ = std::move(node);
+    }
+
+    Expr::Expr(std::shared_ptr<const detail::ExprNode> node) : node_(std::move(node)){}
+
+    std::vector<std::string> Expr::columns() const {
+        std::vector<std::string> names;
+        collect_columns(*this->node_, names);
+        return names;
+    }
+
+    Expr col(std::string name){
+        auto node = std::make_shared<detail::ExprNode>();
+        node->op = detail::Op::Column;
+        node->name = std::move(name);
+        return Expr(std::move(node));
+    }
+
+    Expr operator+(const Expr& a, const Expr& b){return make(detail::Op::Add, a.node(), b.node());}
+    Expr operator-(const Expr& a, const Expr& b){return make(detail::Op::Subtract, a.node(), b.node());}
+    Expr operator*(const Expr& a, const Expr& b){return make(detail::Op::Multiply, a.node(), b.node());}
+    Expr operator/(const Expr& a, const Expr& b){return make(detail::Op::Divide, a.node(), b.node());}
+    Expr operator-(const Expr& a){return make(detail::Op::Negate, a.node());}
+
+    Expr operator<(const Expr& a, const Expr& b){return make(detail::Op::Less, a.node(), b.node());}
+    Expr operator<=(const Expr& a, const Expr& b){return make(detail::Op::LessEqual, a.node(), b.node());}
+    Expr operator>(const Expr& a, const Expr& b){return make(detail::Op::Greater, a.node(), b.node());}
+    Expr operator>=(const Expr& a, const Expr& b){return make(detail::Op::GreaterEqual, a.node(), b.node());}
+    Expr operator==(const Expr& a, const Expr& b){return make(detail::Op::Equal, a.node(), b.node());}
+    Expr operator!=(const Expr& a, const Expr& b){return make(detail::Op::NotEqual, a.node(), b.node());}
+    Expr operator&&(const Expr& a, const Expr& b){return make(detail::Op::And, a.node(), b.node());}
+    Expr operator||(const Expr& a, const Expr& b){return make(detail::Op::Or, a.node(), b.node());}
+    Expr operator!(const Expr& a){return make(detail::Op::Not, a.node());}
+
+    Expr abs(const Expr& a){return make(detail::Op::Abs, a.node());}
+    Expr sqrt(const Expr& a){return make(detail::Op::Sqrt, a.node());}
+    Expr exp(const Expr& a){return make(detail::Op::Exp, a.node());}
+    Expr log(const Expr& a){return make(detail::Op::Log, a.node());}
+    Expr log10(const Expr& a){return make(detail::Op::Log10, a.node());}
+    Expr sin(const Expr& a){return make(detail::Op::Sin, a.node());}
+    Expr cos(const Expr& a){return make(detail::Op::Cos, a.node());}
+    Expr tan(const Expr& a){return make(detail::Op::Tan, a.node());}
+    Expr atan(const Expr& a){return make(detail::Op::Atan, a.node());}
+    Expr floor(const Expr& a){return make(detail::Op::Floor, a.node());}
+    Expr ceil(const Expr& a){return make(detail::Op::Ceil, a.node());}
+    Expr isnan(const Expr& a){return make(detail::Op::IsNaN, a.node());}
+    Expr pow(const Expr& base, const Expr& exponent){return make(detail::Op::Pow, base.node(), exponent.node());}
+    Expr atan2(const Expr& y, const Expr& x){return make(detail::Op::Atan2, y.node(), x.node());}
+    Expr hypot(const Expr& a, const Expr& b){return make(detail::Op::Hypot, a.node(), b.node());}
+    Expr min(const Expr& a, const Expr& b){return make(detail::Op::Min, a.node(), b.node());}
+    Expr max(const Expr& a, const Expr& b){return make(detail::Op::Max, a.node(), b.node());}
+    Expr where(const Expr& condition, const Expr& a, const Expr& b){return make(detail::Op::Where, condition.node(), a.node(), b.node());}
+
+    Column evaluate(const CSVd& table, const Expr& expression, std::string name, const ParallelSettings& parallel){
+        std::vector<std::string> inputs;
+        const detail::Program program(expression, inputs);
+        const size_t rows = BlockStaging(table, inputs).rows(detail::row_count(table));
+
+        Column result;
+        result.name = std::move(name);
+        std::deque<double>& data = result.values();
+        data.resize(rows);
+
+        const size_t blocks = (rows + detail::block_size - 1) / detail::block_size;
+        const unsigned int threads = detail::thread_count(rows, parallel);
+        detail::parallel_for(blocks, threads, [&](unsigned int, size_t first, size_t last){
+            BlockStaging staging(table, inputs);
+            std::vector<double> scratch = program.scratch();
+            for(size_t block = first; block < last; ++block){
+                const size_t offset = block * detail::block_size;
+                const size_t count = std::min(detail::block_size, rows - offset);
+                const double* values = program.run(staging.load(offset, count), count, scratch);
+                std::copy(values, values + count, data.begin() + static_cast<std::ptrdiff_t>(offset));
+            }
+        });
+        result.update_sortedness();
+        result.update_zones();
+        return result;
+    }
+
+    void write(std::ostream& stream, const CSVd& table, const std::vector<NamedExpr>& columns){
+        std::vector<std::string> inputs;
+        std::vector<detail::Program> programs;
+        std::vector<std::string> names;
+        for(const NamedExpr& column : columns){
+            programs.emplace_back(column.expression, inputs);
+            names.push_back(column.name);
+        }
+
+        BlockStaging staging(table, inputs);
+        const size_t rows = staging.rows(detail::row_count(table));
+
+        std::vector<std::vector<double>> scratches;
+        for(const detail::Program& program : programs){
+            scratches.push_back(program.scratch());
+        }
+
+        Writer writer(stream, table.settings());
+        writer.write_header(names);
+        std::vector<const double*> results(programs.size());
+        std::vector<double> row(programs.size());
+        for(size_t offset = 0; offset < rows; offset += detail::block_size){
+            const size_t count = std::min(detail::block_size, rows - offset);
+            const std::span<const double* const> block = staging.load(offset, count);
+            for(size_t p = 0; p < programs.size(); ++p){
+                results[p] = programs[p].run(block, count, scratches[p]);
+            }
+            for(size_t i = 0; i < count; ++i){
+                for(size_t p = 0; p < programs.size(); ++p){
+                    row[p] = results[p][i];
+                }
+                writer.write_row(row);
+            }
+        }
+    }
+
+}// namespace csvd
@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <csvd/filter.hpp>
+
+#include "parallel.hpp"
+
+namespace csvd{
+
+    namespace {
+
+        /**
+         * @brief Writes `1` or `0` into `flags` for every value that passes the comparison
+         */
+        CSVD_TARGET_CLONES
+        void compare_kernel(const double* values, size_t count, Comparison comparison, double x, unsigned char* flags){
+            switch(comparison){
+                break; case Comparison::Less: for(size_t i = 0; i < count; ++i) flags[i] = values[i] < x;
+                break; case Comparison::LessEqual: for(size_t i = 0; i < count; ++i) flags[i] = values[i] <= x;
+                break; case Comparison::Greater: for(size_t i = 0; i < count; ++i) flags[i] = values[i] > x;
+                break; case Comparison::GreaterEqual: for(size_t i = 0; i < count; ++i) flags[i] = values[i] >= x;
+                break; case Comparison::Equal: for(size_t i = 0; i < count; ++i) flags[i] = values[i] == x;
+                break; case Comparison::NotEqual: for(size_t i = 0; i < count; ++i) flags[i] = values[i] != x;
+            }
+        }
+
+        CSVD_TARGET_CLONES
+        void compare_kernel(const double* a, const double* b, size_t count, Comparison comparison, unsigned char* flags){
+            switch(comparison){
+                break; case Comparison::Less: for(size_t i = 0; i < count; ++i) flags[i] = a[i] < b[i];
+                break; case Comparison::LessEqual: for(size_t i = 0; i < count; ++i) flags[i] = a[i] <= b[i];
+                break; case Comparison::Greater: for(size_t i = 0; i < count; ++i) flags[i] = a[i] > b[i];
+                break; case Comparison::GreaterEqual: for(size_t i = 0; i < count; ++i) flags[i] = a[i] >= b[i];
+                break; case Comparison::Equal: for(size_t i = 0; i < count; ++i) flags[i] = a[i] == b[i];
+                break; case Comparison::NotEqual: for(size_t i = 0; i < count; ++i) flags[i] = a[i] != b[i];
+            }
+        }
+
+        CSVD_TARGET_CLONES
+        void between_kernel(const double* values, size_t count, double min, double max, unsigned char* flags){
+            for(size_t i = 0; i < count; ++i){
+                flags[i] = (values[i] >= min) & (values[i] <= max);
+            }
+        }
+
+        /**
+         * @brief How many rows of a zone can pass a test
+         */
+        enum class ZoneMatch{None, Some, All};
+
+        [[nodiscard]] ZoneMatch match(const Zone& zone, Comparison comparison, double x){
+            // the NaN rows of a zone never pass, except for `NotEqual`
+            const bool all_numbers = (zone.has_nan == false);
+            switch(comparison){
+                case Comparison::Less:
+                    if(zone.min >= x) return ZoneMatch::None;
+                    if(all_numbers && zone.max < x) return ZoneMatch::All;
+                    break;
+                case Comparison::LessEqual:
+                    if(zone.min > x) return ZoneMatch::None;
+                    if(all_numbers && zone.max <= x) return ZoneMatch::All;
+                    break;
+                case Comparison::Greater:
+                    if(zone.max <= x) return ZoneMatch::None;
+                    if(all_numbers && zone.min > x) return ZoneMatch::All;
+                    break;
+                case Comparison::GreaterEqual:
+                    if(zone.max < x) return ZoneMatch::None;
+                    if(all_numbers && zone.min >= x) return ZoneMatch::All;
+                    break;
+                case Comparison::Equal:
+                    if(x < zone.min || x > zone.max) return ZoneMatch::None;
+                    if(all_numbers && zone.min == x && zone.max == x) return ZoneMatch::All;
+                    break;
+                case Comparison::NotEqual:
+                    if(x < zone.min || x > zone.max) return ZoneMatch::All;
+                    if(all_numbers && zone.min == x && zone.max == x) return ZoneMatch::None;
+                    break;
+            }
+            return ZoneMatch::Some;
+        }
+
+        [[nodiscard]] ZoneMatch match_between(const Zone& zone, double min, double max){
+            if(zone.max < min || zone.min > max || (min <= max) == false) return ZoneMatch::None;
+            if(zone.has_nan == false && zone.min >= min && zone.max <= max) return ZoneMatch::All;
+            return ZoneMatch::Some;
+        }
+
+        /**
+         * @brief Sets the flags of the rows `[offset, offset + count)` from the zones of the column, if they all agree
+         *
+         * @param match Classifies a zone with `ZoneMatch`
+         * @return `true` if the flags have been set, `false` if the values have to be tested
+         */
+        template<class Match>
+        [[nodiscard]] bool flags_from_zones(const Column& column, bool has_zones, size_t offset, size_t count, unsigned char* flags, Match&& match){
+            if(has_zones == false){
+                return false;
+            }
+            const size_t first = offset / zone_size;
+            const size_t last = (offset + count - 1) / zone_size;
+            const ZoneMatch result = match(column.zones[first]);
+            if(result == ZoneMatch::Some){
+                return false;
+            }
+            for(size_t zone = first + 1; zone <= last; ++zone){
+                if(match(column.zones[zone]) != result){
+                    return false;
+                }
+            }
+            std::memset(flags, (result == ZoneMatch::All) ? 1 : 0, count);
+            return true;
+        }
+
+        /**
+         * @brief Packs `count` flags of `0` or `1` into bits, starting at bit 0 of `words[0]`
+         *
+         * `count` has to be a multiple of 64 except for the last block.
+         */
+        void pack(const unsigned char* flags, size_t count, std::uint64_t* words){
+            for(size_t word = 0; word * 64 < count; ++word){
+                const size_t n = std::min<size_t>(64, count - word * 64);
+                std::uint64_t bits = 0;
+                if constexpr (std::endian::native == std::endian::little){
+                    size_t i = 0;
+                    for(; i + 8 <= n; i += 8){
+                        // gathers the lowest bit of 8 bytes into one byte
+                        std::uint64_t eight;
+                        std::memcpy(&eight, flags + word * 64 + i, sizeof(eight));
+                        bits |= ((eight * 0x0102040810204080ull) >> 56) << i;
+                    }
+                    for(; i < n; ++i){
+                        bits |= std::uint64_t(flags[word * 64 + i]) << i;
+                    }
+                }else{
+                    for(size_t i = 0; i < n; ++i){
+                        bits |= std::uint64_t(flags[word * 64 + i]) << i;
+                    }
+                }
+                words[word] = bits;
+            }
+        }
+
+        /**
+         * @brief Builds a selection of `rows` rows by running `kernel(first, last, flags)` on word aligned blocks in parallel
+         */
+        template<class Kernel>
+        Selection select(size_t rows, const ParallelSettings& parallel, Kernel&& kernel){
+            Selection selection(rows);
+            const std::span<std::uint64_t> words = selection.words();
+            const unsigned int threads = detail::thread_count(rows, parallel);
+            detail::parallel_for(words.size(), threads, [&](unsigned int, size_t first_word, size_t last_word){
+                const size_t first = first_word * 64;
+                const size_t last = std::min(rows, last_word * 64);
+                alignas(64) unsigned char flags[detail::block_size];
+                for(size_t offset = first; offset < last; offset += detail::block_size){
+                    const size_t count = std::min(detail::block_size, last - offset);
+                    kernel(offset, count, flags);
+                    pack(flags, count, words.data() + offset / 64);
+                }
+            });
+            return selection;
+        }
+
+        /**
+         * @brief Copies `rows` of every column into a new table, the columns are distributed over threads
+         */
+        CSVd gather(const CSVd& table, std::span<const size_t> rows, const ParallelSettings& parallel){
+            CSVd result(table.settings());
+            for(const Column& column : table){
+                result.push_back(column.clone_empty());
+            }
+
+            const unsigned int threads = std::min<unsigned int>(
+                detail::thread_count(rows.size() * table.size(), parallel),
+                static_cast<unsigned int>(std::max<size_t>(table.size(), 1)));
+            detail::parallel_for(table.size(), threads, [&](unsigned int, size_t first, size_t last){
+                for(size_t c = first; c < last; ++c){
+                    const Column& source = table[c];
+                    Column& destination = result[c];
+                    const size_t size = source.data.size();
+                    for(const size_t row : rows){
+                        if(row < size){
+                            destination.push_back(source.data[row]);
+                        }
+                    }
+                }
+            });
+            return result;
+        }
+
+    }// namespace
+
+    Selection::Selection(size_t rows, bool selected)
+        : words_((rows + 63) / 64, selected ? ~std::uint64_t(0) : std::uint64_t(0))
+        , size_(rows)
+    {
+        this->clear_tail();
+    }
+
+    void Selection::clear_tail(){
+        const size_t tail = this->size_ % 64;
+        if(tail != 0){
+            this->words_.back() &= (std::uint64_t(1) << tail) - 1;
+        }
+    }
+
+    size_t Selection::count() const {
+        size_t result = 0;
+        for(const std::uint64_t word : this->words_){
+            result += static_cast<size_t>(std::popcount(word));
+        }
+        return result;
+    }
+
+    std::vector<size_t> Selection::indices() const {
+        std::vector<size_t> result;
+        result.reserve(this->count());
+        for(size_t w = 0; w < this->words_.size(); ++w){
+            std::uint64_t word = this->words_[w];
+            while(word != 0){
+                result.push_back(w * 64 + static_cast<size_t>(std::countr_zero(word)));
+                word &= word - 1;
+            }
+        }
+        return result;
+    }
+
+    Selection& Selection::operator&=(const Selection& other){
+        const size_t common = std::min(this->words_.size(), other.words_.size());
+        for(size_t w = 0; w < common; ++w){
+            this->words_[w] &= other.words_[w];
+        }
+        std::fill(this->words_.begin() + common, this->words_.end(), std::uint64_t(0));
+        if(other.size_ > this->size_){
+            this->words_.resize(other.words_.size(), 0);
+            this->size_ = other.size_;
+        }
+        return *this;
+    }
+
+    Selection& Selection::operator|=(const Selection& other){
+        if(other.size_ > this->size_){
+            this->words_.resize(other.words_.size(), 0);
+            this->size_ = other.size_;
+        }
+        for(size_t w = 0; w < other.words_.size(); ++w){
+            this->words_[w] |= other.words_[w];
+        }
+        return *this;
+    }
+
+    Selection Selection::operator~() const {
+        Selection result = *this;
+        for(std::uint64_t& word : result.words_){
+            word = ~word;
+        }
+        result.clear_tail();
+        return result;
+    }
+
+    Selection compare(const Column& column, Comparison comparison, double value, const ParallelSettings& parallel){
+        const bool has_zones = column.has_zones();
+        return select(column.data.size(), parallel, [&](size_t offset, size_t count, unsigned char* flags){
+            if(flags_from_zones(column, has_zones, offset, count, flags, [&](const Zone& zone){return match(zone, comparison, value);})){
+                return;
+            }
+            detail::for_each_block(column.data, offset, offset + count, [&](const double* values, size_t n, size_t block_offset){
+                compare_kernel(values, n, comparison, value, flags + (block_offset - offset));
+            });
+        });
+    }
+
+    Selection compare(const Column& a, Comparison comparison, const Column& b, const ParallelSettings& parallel){
+        const size_t rows = std::min(a.data.size(), b.data.size());
+        return select(rows, parallel, [&](size_t offset, size_t count, unsigned char* flags){
+            detail::for_each_block(a.data, b.data, offset, offset + count, [&](const double* values_a, const double* values_b, size_t n, size_t block_offset){
+                compare_kernel(values_a, values_b, n, comparison, flags + (block_offset - offset));
+            });
+        });
+    }
+
+    Selection between(const Column& column, double min, double max, const ParallelSettings& parallel){
+        const bool has_zones = column.has_zones();
+        return select(column.data.size(), parallel, [&](size_t offset, size_t count, unsigned char* flags){
+            if(flags_from_zones(column, has_zones, offset, count, flags, [&](const Zone& zone){return match_between(zone, min, max);})){
+                return;
+            }
+            detail::for_each_block(column.data, offset, offset + count, [&](const double* values, size_t n, size_t block_offset){
+                between_kernel(values, n, min, max, flags + (block_offset - offset));
+            });
+        });
+    }
+
+    CSVd filter(const CSVd& table, const Selection& selection, const ParallelSettings& parallel){
+        const std::vector<size_t> rows = selection.indices();
+        return gather(table, rows, parallel);
+    }
+
+    CSVd take(const CSVd& table, std::span<const size_t> rows, const ParallelSettings& parallel){
+        return gather(table, rows, parallel);
+    }
+
+}// namespace csvd
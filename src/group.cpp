@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <csvd/group.hpp>
+
+#include "parallel.hpp"
+#include "columns.hpp"
+#include "groups.hpp"
+
+namespace csvd{
+
+    namespace {
+
+        /**
+         * @brief The inputs of one aggregation: key bits per key column (column major) and the value columns
+         */
+        struct Input{
+            size_t rows;
+            std::vector<std::vector<std::uint64_t>> keys;
+            std::vector<const Column*> values;
+
+            void load_key(size_t row, std::uint64_t* key) const {
+                for(size_t k = 0; k < this->keys.size(); ++k){
+                    key[k] = this->keys[k][row];
+                }
+            }
+        };
+
+        [[nodiscard]] bool keys_sorted(const Input& input){
+            std::vector<std::uint64_t> previous(input.keys.size());
+            std::vector<std::uint64_t> current(input.keys.size());
+            for(size_t row = 1; row < input.rows; ++row){
+                input.load_key(row - 1, previous.data());
+                input.load_key(row, current.data());
+                if(detail::key_less(current.data(), previous.data(), current.size())){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Calls `function(row, value_index, value)` for all values of `[first, last)`
+         */
+        template<class Function>
+        void for_each_value(const Input& input, size_t first, size_t last, Function&& function){
+            for(size_t v = 0; v < input.values.size(); ++v){
+                auto value = input.values[v]->data.begin() + static_cast<std::ptrdiff_t>(first);
+                for(size_t row = first; row < last; ++row, ++value){
+                    function(row, v, *value);
+                }
+            }
+        }
+
+        /**
+         * @brief Groups sorted keys by scanning the runs of equal keys, one row range per thread
+         */
+        detail::Groups sorted_groups(const Input& input, const ParallelSettings& parallel){
+            const size_t key_count = input.keys.size();
+            const size_t value_count = input.values.size();
+            const unsigned int threads = detail::thread_count(input.rows, parallel);
+            std::vector<detail::Groups> partials(threads, detail::Groups(key_count, value_count));
+            detail::parallel_for(input.rows, threads, [&](unsigned int part, size_t first, size_t last){
+                detail::Groups& groups = partials[part];
+                std::vector<std::uint64_t> key(key_count);
+                std::vector<size_t> group_of_row(last - first);
+                for(size_t row = first; row < last; ++row){
+                    input.load_key(row, key.data());
+                    if(groups.size() == 0 || groups.key_equals(groups.size() - 1, key.data()) == false){
+                        groups.add(key.data());
+                    }
+                    group_of_row[row - first] = groups.size() - 1;
+                }
+                for_each_value(input, first, last, [&](size_t row, size_t v, double value){
+                    groups.accumulators(group_of_row[row - first])[v].push(value);
+                });
+            });
+
+            // a run of equal keys can span neighbouring ranges
+            detail::Groups result = std::move(partials[0]);
+            for(size_t part = 1; part < partials.size(); ++part){
+                const detail::Groups& partial = partials[part];
+                for(size_t group = 0; group < partial.size(); ++group){
+                    if(group == 0 && result.size() > 0 && result.key_equals(result.size() - 1, partial.key(group))){
+                        result.merge_into(result.size() - 1, partial.accumulators(group));
+                    }else{
+                        result.merge_into(result.add(partial.key(group)), partial.accumulators(group));
+                    }
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Groups arbitrary keys with one hash table per thread, the partial tables are merged at the end
+         */
+        detail::Groups hashed_groups(const Input& input, const ParallelSettings& parallel){
+            const size_t key_count = input.keys.size();
+            const size_t value_count = input.values.size();
+            const unsigned int threads = detail::thread_count(input.rows, parallel);
+            std::vector<detail::GroupTable> partials(threads, detail::GroupTable(key_count, value_count));
+            detail::parallel_for(input.rows, threads, [&](unsigned int part, size_t first, size_t last){
+                detail::GroupTable& table = partials[part];
+                std::vector<std::uint64_t> key(key_count);
+                std::vector<size_t> group_of_row(last - first);
+                for(size_t row = first; row < last; ++row){
+                    input.load_key(row, key.data());
+                    group_of_row[row - first] = table.insert(key.data());
+                }
+                for_each_value(input, first, last, [&](size_t row, size_t v, double value){
+                    table.groups().accumulators(group_of_row[row - first])[v].push(value);
+                });
+            });
+
+            detail::GroupTable& result = partials[0];
+            for(size_t part = 1; part < partials.size(); ++part){
+                detail::Groups& partial = partials[part].groups();
+                for(size_t group = 0; group < partial.size(); ++group){
+                    const size_t target = result.insert(partial.key(group));
+                    result.groups().merge_into(target, partial.accumulators(group));
+                }
+            }
+            return std::move(result.groups());
+        }
+
+    }// namespace
+
+    GroupBy::GroupBy(const CSVd& table, std::vector<std::string> keys, const ParallelSettings& parallel)
+        : table_(&table)
+        , keys_(std::move(keys))
+        , parallel_(parallel)
+    {}
+
+    CSVd GroupBy::aggregate(const std::vector<Aggregation>& aggregations) const {
+        const CSVd& table = *this->table_;
+
+        Input input;
+        input.rows = detail::row_count(table);
+        for(const std::string& name : this->keys_){
+            const Column& column = detail::column_by_name(table, name);
+            std::vector<std::uint64_t>& bits = input.keys.emplace_back(input.rows);
+            for(size_t row = 0; row < input.rows; ++row){
+                bits[row] = detail::key_bits(column.data[row]);
+            }
+        }
+
+        // every value column is accumulated once, even if it has multiple aggregations
+        std::vector<size_t> value_of_aggregation;
+        for(const Aggregation& aggregation : aggregations){
+            const Column* column = &detail::column_by_name(table, aggregation.column);
+            const auto found = std::ranges::find(input.values, column);
+            value_of_aggregation.push_back(static_cast<size_t>(found - input.values.begin()));
+            if(found == input.values.end()){
+                input.values.push_back(column);
+            }
+        }
+
+        const detail::Groups groups = keys_sorted(input) ? sorted_groups(input, this->parallel_) : hashed_groups(input, this->parallel_);
+        return detail::group_table(groups, this->keys_, aggregations, value_of_aggregation, table.settings());
+    }
+
+    GroupBy group_by(const CSVd& table, std::vector<std::string> keys, const ParallelSettings& parallel){
+        return GroupBy(table, std::move(keys), parallel);
+    }
+
+}// namespace csvd
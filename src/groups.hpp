@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <csvd/group.hpp>
+
+#include "parallel.hpp"
+#include "columns.hpp"
+
+/**
+ * Building blocks of `group_by`, shared with the streaming aggregation of `Query`
+ */
+namespace csvd::detail{
+
+    inline constexpr size_t no_group = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief Partial aggregates of one value column within one group
+     */
+    struct Accumulator{
+        size_t count = 0;
+        NeumaierSum sum;
+        double min = std::numeric_limits<double>::infinity();
+        double max = -std::numeric_limits<double>::infinity();
+
+        inline void push(double value){
+            if(std::isnan(value)) return;
+            ++this->count;
+            this->sum.add(value);
+            this->min = std::min(this->min, value);
+            this->max = std::max(this->max, value);
+        }
+
+        inline void merge(const Accumulator& other){
+            this->count += other.count;
+            this->sum.add(other.sum.result());
+            this->min = std::min(this->min, other.min);
+            this->max = std::max(this->max, other.max);
+        }
+
+        [[nodiscard]] double result(Aggregate function) const {
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            switch(function){
+                case Aggregate::Sum: return this->sum.result();
+                case Aggregate::Mean: return (this->count == 0) ? nan : this->sum.result() / static_cast<double>(this->count);
+                case Aggregate::Min: return (this->count == 0) ? nan : this->min;
+                case Aggregate::Max: return (this->count == 0) ? nan : this->max;
+                case Aggregate::Count: return static_cast<double>(this->count);
+            }
+            return nan;
+        }
+    };
+
+    [[nodiscard]] inline const char* suffix(Aggregate function){
+        switch(function){
+            case Aggregate::Sum: return "_sum";
+            case Aggregate::Mean: return "_mean";
+            case Aggregate::Min: return "_min";
+            case Aggregate::Max: return "_max";
+            case Aggregate::Count: return "_count";
+        }
+        return "";
+    }
+
+    /**
+     * @brief Bit pattern of a key value. Values that compare equal get the same bits and all NaNs form one key.
+     */
+    [[nodiscard]] inline std::uint64_t key_bits(double value){
+        if(std::isnan(value)) return std::bit_cast<std::uint64_t>(std::numeric_limits<double>::quiet_NaN());
+        return std::bit_cast<std::uint64_t>(value + 0.0);
+    }
+
+    [[nodiscard]] inline std::uint64_t hash(const std::uint64_t* key, size_t count){
+        std::uint64_t x = 0;
+        for(size_t k = 0; k < count; ++k){
+            // splitmix64 finalizer
+            x ^= key[k];
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ull;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebull;
+            x ^= x >> 31;
+        }
+        return x;
+    }
+
+    /**
+     * @brief Lexicographic order of two keys in the order of their values
+     */
+    [[nodiscard]] inline bool key_less(const std::uint64_t* lhs, const std::uint64_t* rhs, size_t count){
+        for(size_t k = 0; k < count; ++k){
+            const std::uint64_t a = order_key(std::bit_cast<double>(lhs[k]));
+            const std::uint64_t b = order_key(std::bit_cast<double>(rhs[k]));
+            if(a != b){
+                return a < b;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Flat storage of the keys and the accumulators of all groups
+     */
+    class Groups{
+        public:
+            Groups(size_t key_count, size_t value_count) : key_count_(key_count), value_count_(value_count){}
+
+            size_t add(const std::uint64_t* key){
+                this->keys_.insert(this->keys_.end(), key, key + this->key_count_);
+                this->accumulators_.resize(this->accumulators_.size() + this->value_count_);
+                return this->size_++;
+            }
+
+            [[nodiscard]] bool key_equals(size_t group, const std::uint64_t* key) const {
+                return std::equal(key, key + this->key_count_, this->key(group));
+            }
+
+            [[nodiscard]] size_t size() const {return this->size_;}
+            [[nodiscard]] size_t key_count() const {return this->key_count_;}
+            [[nodiscard]] const std::uint64_t* key(size_t group) const {return this->keys_.data() + group * this->key_count_;}
+            [[nodiscard]] Accumulator* accumulators(size_t group) {return this->accumulators_.data() + group * this->value_count_;}
+            [[nodiscard]] const Accumulator* accumulators(size_t group) const {return this->accumulators_.data() + group * this->value_count_;}
+
+            void merge_into(size_t group, const Accumulator* other){
+                Accumulator* accumulators = this->accumulators(group);
+                for(size_t v = 0; v < this->value_count_; ++v){
+                    accumulators[v].merge(other[v]);
+                }
+            }
+
+        private:
+            size_t key_count_;
+            size_t value_count_;
+            size_t size_ = 0;
+            std::vector<std::uint64_t> keys_;
+            std::vector<Accumulator> accumulators_;
+    };
+
+    /**
+     * @brief Open addressing hash table with linear probing that maps keys onto groups
+     */
+    class GroupTable{
+        public:
+            GroupTable(size_t key_count, size_t value_count) : groups_(key_count, value_count){}
+
+            /**
+             * @brief Returns the group of the key, a new group is added if the key does not exist yet
+             */
+            size_t insert(const std::uint64_t* key){
+                if((this->groups_.size() + 1) * 2 > this->slots_.size()){
+                    this->rehash(std::max<size_t>(16, this->slots_.size() * 2));
+                }
+                const std::uint64_t h = hash(key, this->groups_.key_count());
+                const size_t mask = this->slots_.size() - 1;
+                for(size_t slot = static_cast<size_t>(h) & mask;; slot = (slot + 1) & mask){
+                    const size_t group = this->slots_[slot];
+                    if(group == no_group){
+                        this->slots_[slot] = this->groups_.add(key);
+                        this->hashes_.push_back(h);
+                        return this->slots_[slot];
+                    }
+                    if(this->hashes_[group] == h && this->groups_.key_equals(group, key)){
+                        return group;
+                    }
+                }
+            }
+
+            [[nodiscard]] Groups& groups() {return this->groups_;}
+
+        private:
+            void rehash(size_t capacity){
+                this->slots_.assign(capacity, no_group);
+                const size_t mask = capacity - 1;
+                for(size_t group = 0; group < this->hashes_.size(); ++group){
+                    size_t slot = static_cast<size_t>(this->hashes_[group]) & mask;
+                    while(this->slots_[slot] != no_group){
+                        slot = (slot + 1) & mask;
+                    }
+                    this->slots_[slot] = group;
+                }
+            }
+
+            Groups groups_;
+            std::vector<size_t> slots_;
+            std::vector<std::uint64_t> hashes_; ///< per group
+    };
+
+    /**
+     * @brief Builds the result table of an aggregation with one row per group, sorted by the keys
+     *
+     * @param value_of_aggregation The index of the accumulator of every aggregation
+     */
+    [[nodiscard]] inline CSVd group_table(const Groups& groups, const std::vector<std::string>& keys, const std::vector<Aggregation>& aggregations,
+        const std::vector<size_t>& value_of_aggregation, const Settings& settings)
+    {
+        std::vector<size_t> order(groups.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::ranges::sort(order, [&](size_t lhs, size_t rhs){
+            return key_less(groups.key(lhs), groups.key(rhs), groups.key_count());
+        });
+
+        CSVd result(settings);
+        for(size_t k = 0; k < keys.size(); ++k){
+            Column column;
+            column.name = keys[k];
+            for(const size_t group : order){
+                column.push_back(std::bit_cast<double>(groups.key(group)[k]));
+            }
+            result.push_back(std::move(column));
+        }
+        for(size_t a = 0; a < aggregations.size(); ++a){
+            Column column;
+            column.name = aggregations[a].column + suffix(aggregations[a].function);
+            for(const size_t group : order){
+                column.push_back(groups.accumulators(group)[value_of_aggregation[a]].result(aggregations[a].function));
+            }
+            result.push_back(std::move(column));
+        }
+        return result;
+    }
+
+}// namespace csvd::detail
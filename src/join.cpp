@@ -0,0 +1,438 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <csvd/join.hpp>
+
+#include "parallel.hpp"
+#include "columns.hpp"
+
+namespace csvd{
+
+    namespace {
+
+        constexpr size_t no_row = std::numeric_limits<size_t>::max();
+
+        /// Number of partitions of the hash join, small enough that every partition table fits into the cache for typical sizes
+        constexpr size_t partition_bits = 6;
+        constexpr size_t partitions = size_t(1) << partition_bits;
+
+        struct Match{
+            size_t left;
+            size_t right; ///< `no_row` for unmatched rows of a left join
+        };
+
+        [[nodiscard]] std::vector<double> copy_keys(const Column& column, size_t rows){
+            return std::vector<double>(column.data.begin(), column.data.begin() + static_cast<std::ptrdiff_t>(rows));
+        }
+
+        /**
+         * @brief Returns `true` if the keys are ascending and contain no NaN
+         */
+        [[nodiscard]] bool is_sorted_ascending(const std::vector<double>& keys){
+            for(size_t i = 0; i < keys.size(); ++i){
+                if(std::isnan(keys[i]) || (i > 0 && keys[i - 1] > keys[i])){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Hash of a key value. `-0.0` and `0.0` hash equally because they compare equal.
+         */
+        [[nodiscard]] inline std::uint64_t hash(double key){
+            std::uint64_t x = std::bit_cast<std::uint64_t>(key + 0.0);
+            // splitmix64 finalizer
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ull;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebull;
+            x ^= x >> 31;
+            return x;
+        }
+
+        [[nodiscard]] inline size_t partition_of(std::uint64_t h){
+            return static_cast<size_t>(h >> (64 - partition_bits));
+        }
+
+        /**
+         * @brief Merges sorted keys, one left range per thread
+         */
+        std::vector<Match> merge_join(const std::vector<double>& left, const std::vector<double>& right, bool keep_unmatched, const ParallelSettings& parallel){
+            const unsigned int threads = detail::thread_count(left.size(), parallel);
+            std::vector<std::vector<Match>> partials(threads);
+            detail::parallel_for(left.size(), threads, [&](unsigned int part, size_t first, size_t last){
+                if(first == last) return;
+                std::vector<Match>& matches = partials[part];
+                size_t r = static_cast<size_t>(std::ranges::lower_bound(right, left[first]) - right.begin());
+                for(size_t l = first; l < last; ++l){
+                    const double key = left[l];
+                    while(r < right.size() && right[r] < key){
+                        ++r;
+                    }
+                    // the equal range is not consumed, the next left row can have the same key
+                    size_t e = r;
+                    for(; e < right.size() && right[e] == key; ++e){
+                        matches.push_back(Match{l, e});
+                    }
+                    if(e == r && keep_unmatched){
+                        matches.push_back(Match{l, no_row});
+                    }
+                }
+            });
+
+            std::vector<Match> result;
+            for(std::vector<Match>& partial : partials){
+                result.insert(result.end(), partial.begin(), partial.end());
+            }
+            return result;
+        }
+
+        /**
+         * @brief Groups the row indices by the partition of their key hash
+         *
+         * Every thread counts its range, then all threads scatter into disjoint slots.
+         * Within a partition the rows stay in ascending order. NaN keys are left out.
+         *
+         * @param offsets receives `partitions + 1` offsets into the returned rows
+         */
+        std::vector<size_t> partition(const std::vector<double>& keys, std::vector<size_t>& offsets, const ParallelSettings& parallel){
+            const size_t n = keys.size();
+            const unsigned int threads = detail::thread_count(n, parallel);
+            std::vector<std::array<size_t, partitions>> histograms(threads);
+            detail::parallel_for(n, threads, [&](unsigned int part, size_t first, size_t last){
+                histograms[part].fill(0);
+                for(size_t i = first; i < last; ++i){
+                    if(std::isnan(keys[i]) == false){
+                        ++histograms[part][partition_of(hash(keys[i]))];
+                    }
+                }
+            });
+
+            // exclusive prefix sum ordered by partition, then by thread
+            offsets.assign(partitions + 1, 0);
+            size_t offset = 0;
+            for(size_t p = 0; p < partitions; ++p){
+                offsets[p] = offset;
+                for(unsigned int part = 0; part < threads; ++part){
+                    const size_t count = histograms[part][p];
+                    histograms[part][p] = offset;
+                    offset += count;
+                }
+            }
+            offsets[partitions] = offset;
+
+            std::vector<size_t> rows(offset);
+            detail::parallel_for(n, threads, [&](unsigned int part, size_t first, size_t last){
+                for(size_t i = first; i < last; ++i){
+                    if(std::isnan(keys[i]) == false){
+                        rows[histograms[part][partition_of(hash(keys[i]))]++] = i;
+                    }
+                }
+            });
+            return rows;
+        }
+
+        /**
+         * @brief Radix-partitioned hash join. Builds and probes one open addressing table per partition.
+         */
+        std::vector<Match> hash_join(const std::vector<double>& left, const std::vector<double>& right, bool keep_unmatched, const ParallelSettings& parallel){
+            std::vector<size_t> left_offsets;
+            std::vector<size_t> right_offsets;
+            const std::vector<size_t> left_rows = partition(left, left_offsets, parallel);
+            const std::vector<size_t> right_rows = partition(right, right_offsets, parallel);
+
+            std::vector<std::vector<Match>> partials(partitions);
+            const unsigned int threads = detail::thread_count(left.size() + right.size(), parallel);
+            detail::parallel_for(partitions, threads, [&](unsigned int, size_t first, size_t last){
+                std::vector<size_t> slots;
+                for(size_t p = first; p < last; ++p){
+                    const size_t build_size = right_offsets[p + 1] - right_offsets[p];
+                    if(build_size == 0 || left_offsets[p + 1] == left_offsets[p]){
+                        continue;
+                    }
+
+                    // build
+                    const size_t capacity = std::bit_ceil(2 * build_size);
+                    const size_t mask = capacity - 1;
+                    slots.assign(capacity, no_row);
+                    for(size_t i = right_offsets[p]; i < right_offsets[p + 1]; ++i){
+                        const size_t row = right_rows[i];
+                        size_t slot = static_cast<size_t>(hash(right[row])) & mask;
+                        while(slots[slot] != no_row){
+                            slot = (slot + 1) & mask;
+                        }
+                        slots[slot] = row;
+                    }
+
+                    // probe
+                    std::vector<Match>& matches = partials[p];
+                    for(size_t i = left_offsets[p]; i < left_offsets[p + 1]; ++i){
+                        const size_t row = left_rows[i];
+                        const double key = left[row];
+                        size_t slot = static_cast<size_t>(hash(key)) & mask;
+                        while(slots[slot] != no_row){
+                            if(right[slots[slot]] == key){
+                                matches.push_back(Match{row, slots[slot]});
+                            }
+                            slot = (slot + 1) & mask;
+                        }
+                    }
+                }
+            });
+
+            // order the matches by left row with a counting sort, unmatched rows are added for left joins
+            std::vector<size_t> starts(left.size() + 1, 0);
+            for(const std::vector<Match>& partial : partials){
+                for(const Match& match : partial){
+                    ++starts[match.left];
+                }
+            }
+            if(keep_unmatched){
+                for(size_t& count : starts){
+                    count = std::max<size_t>(count, 1);
+                }
+                starts.back() = 0;
+            }
+            size_t offset = 0;
+            for(size_t& start : starts){
+                const size_t count = start;
+                start = offset;
+                offset += count;
+            }
+
+            std::vector<Match> result(offset, Match{no_row, no_row});
+            std::vector<size_t> positions(starts.begin(), starts.end() - 1);
+            for(const std::vector<Match>& partial : partials){
+                for(const Match& match : partial){
+                    result[positions[match.left]++] = match;
+                }
+            }
+            for(size_t l = 0; l < left.size(); ++l){
+                const auto first = result.begin() + static_cast<std::ptrdiff_t>(starts[l]);
+                const auto last = result.begin() + static_cast<std::ptrdiff_t>(starts[l + 1]);
+                if(first == last) continue;
+                if(positions[l] == starts[l]){
+                    *first = Match{l, no_row}; // unmatched row of a left join
+                }else if(last - first > 1){
+                    std::sort(first, last, [](const Match& a, const Match& b){return a.right < b.right;});
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Returns the columns of the right table without its key column
+         */
+        [[nodiscard]] std::vector<const Column*> value_columns(const CSVd& right, const Column& right_key){
+            std::vector<const Column*> result;
+            for(const Column& column : right){
+                if(&column != &right_key){
+                    result.push_back(&column);
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Creates the empty output table: all left columns followed by the right value columns
+         *
+         * Names that exist on both sides get the suffixes from the settings.
+         */
+        [[nodiscard]] CSVd output_table(const CSVd& left, const std::vector<const Column*>& right_columns, const JoinSettings& settings){
+            const auto in_right = [&](const std::string& name){
+                return std::ranges::any_of(right_columns, [&](const Column* column){return column->name == name;});
+            };
+
+            CSVd result(left.settings());
+            for(const Column& column : left){
+                Column output = column.clone_empty();
+                if(output.name.empty() == false && in_right(output.name)){
+                    output.name += settings.left_suffix;
+                }
+                result.push_back(std::move(output));
+            }
+            for(const Column* column : right_columns){
+                Column output = column->clone_empty();
+                if(output.name.empty() == false && left.find(output.name) != left.end()){
+                    output.name += settings.right_suffix;
+                }
+                result.push_back(std::move(output));
+            }
+            return result;
+        }
+
+        /**
+         * @brief Calls `fill(column_index, output_column)` for every output column, distributed over threads
+         */
+        template<class Function>
+        void fill_columns(CSVd& result, size_t rows, const ParallelSettings& parallel, Function&& fill){
+            const size_t columns = result.size();
+            const unsigned int threads = std::min<unsigned int>(
+                detail::thread_count(rows * columns, parallel),
+                static_cast<unsigned int>(std::max<size_t>(columns, 1)));
+            detail::parallel_for(columns, threads, [&](unsigned int, size_t first, size_t last){
+                for(size_t c = first; c < last; ++c){
+                    fill(c, result[c]);
+                }
+            });
+        }
+
+        /**
+         * @brief Builds the output table from the matched row pairs
+         */
+        CSVd assemble(const CSVd& left, const CSVd& right, const Column& right_key, const std::vector<Match>& matches, const JoinSettings& settings, const ParallelSettings& parallel){
+            const std::vector<const Column*> right_columns = value_columns(right, right_key);
+            CSVd result = output_table(left, right_columns, settings);
+            fill_columns(result, matches.size(), parallel, [&](size_t c, Column& output){
+                if(c < left.size()){
+                    const std::deque<double>& source = left[c].data;
+                    for(const Match& match : matches){
+                        output.push_back(source[match.left]);
+                    }
+                }else{
+                    const std::deque<double>& source = right_columns[c - left.size()]->data;
+                    for(const Match& match : matches){
+                        output.push_back((match.right != no_row) ? source[match.right] : std::numeric_limits<double>::quiet_NaN());
+                    }
+                }
+            });
+            return result;
+        }
+
+        CSVd join(const CSVd& left, const CSVd& right, std::string_view left_key, std::string_view right_key,
+            bool keep_unmatched, const JoinSettings& settings, const ParallelSettings& parallel)
+        {
+            const Column& left_key_column = detail::column_by_name(left, left_key);
+            const Column& right_key_column = detail::column_by_name(right, right_key);
+
+            const std::vector<double> left_keys = copy_keys(left_key_column, detail::row_count(left));
+            const std::vector<double> right_keys = copy_keys(right_key_column, detail::row_count(right));
+
+            const std::vector<Match> matches = (is_sorted_ascending(left_keys) && is_sorted_ascending(right_keys))
+                ? merge_join(left_keys, right_keys, keep_unmatched, parallel)
+                : hash_join(left_keys, right_keys, keep_unmatched, parallel);
+
+            return assemble(left, right, right_key_column, matches, settings, parallel);
+        }
+
+        /**
+         * @brief Describes how the right values of one left row of an as-of join are computed
+         *
+         * `value = (1 - weight) * right[first] + weight * right[second]`. `first == no_row` yields NaN.
+         */
+        struct AsofSource{
+            size_t first = no_row;
+            size_t second = no_row;
+            double weight = 0;
+        };
+
+        [[nodiscard]] AsofSource asof_source(const std::vector<double>& right, size_t following, double time, const AsofSettings& settings){
+            // `following` is the number of right rows at or before `time`
+            const bool has_before = following > 0;
+            const size_t before = following - 1;
+            const bool exact = has_before && right[before] == time;
+            const bool has_after = exact || following < right.size();
+            const size_t after = exact ? before : following;
+
+            const double distance_before = has_before ? (time - right[before]) : std::numeric_limits<double>::infinity();
+            const double distance_after = has_after ? (right[after] - time) : std::numeric_limits<double>::infinity();
+
+            AsofSource source;
+            switch(settings.direction){
+                break; case AsofDirection::Backward:{
+                    if(has_before && distance_before <= settings.tolerance) source.first = before;
+                }
+                break; case AsofDirection::Forward:{
+                    if(has_after && distance_after <= settings.tolerance) source.first = after;
+                }
+                break; case AsofDirection::Nearest:{
+                    if(distance_before <= distance_after){
+                        if(has_before && distance_before <= settings.tolerance) source.first = before;
+                    }else{
+                        if(has_after && distance_after <= settings.tolerance) source.first = after;
+                    }
+                }
+                break; case AsofDirection::Interpolate:{
+                    if(exact){
+                        source.first = before;
+                    }else if(has_before && has_after && std::max(distance_before, distance_after) <= settings.tolerance){
+                        source.first = before;
+                        source.second = after;
+                        source.weight = distance_before / (right[after] - right[before]);
+                    }
+                }
+            }
+            return source;
+        }
+
+    }// namespace
+
+    CSVd inner_join(const CSVd& left, const CSVd& right, std::string_view left_key, std::string_view right_key,
+        const JoinSettings& settings, const ParallelSettings& parallel)
+    {
+        return join(left, right, left_key, right_key, false, settings, parallel);
+    }
+
+    CSVd left_join(const CSVd& left, const CSVd& right, std::string_view left_key, std::string_view right_key,
+        const JoinSettings& settings, const ParallelSettings& parallel)
+    {
+        return join(left, right, left_key, right_key, true, settings, parallel);
+    }
+
+    CSVd asof_join(const CSVd& left, const CSVd& right, std::string_view left_time, std::string_view right_time,
+        const AsofSettings& settings, const ParallelSettings& parallel)
+    {
+        const Column& left_time_column = detail::column_by_name(left, left_time);
+        const Column& right_time_column = detail::column_by_name(right, right_time);
+        const std::vector<double> left_times = copy_keys(left_time_column, detail::row_count(left));
+        const std::vector<double> right_times = copy_keys(right_time_column, detail::row_count(right));
+        if(is_sorted_ascending(left_times) == false || is_sorted_ascending(right_times) == false){
+            throw std::invalid_argument("csvd: asof_join requires time columns that are sorted ascending");
+        }
+
+        // one merge pass per time partition of the left table
+        std::vector<AsofSource> sources(left_times.size());
+        const unsigned int threads = detail::thread_count(left_times.size(), parallel);
+        detail::parallel_for(left_times.size(), threads, [&](unsigned int, size_t first, size_t last){
+            if(first == last) return;
+            size_t following = static_cast<size_t>(std::ranges::upper_bound(right_times, left_times[first]) - right_times.begin());
+            for(size_t l = first; l < last; ++l){
+                while(following < right_times.size() && right_times[following] <= left_times[l]){
+                    ++following;
+                }
+                sources[l] = asof_source(right_times, following, left_times[l], settings);
+            }
+        });
+
+        const std::vector<const Column*> right_columns = value_columns(right, right_time_column);
+        CSVd result = output_table(left, right_columns, settings.naming);
+        fill_columns(result, sources.size(), parallel, [&](size_t c, Column& output){
+            if(c < left.size()){
+                const std::deque<double>& data = left[c].data;
+                for(size_t l = 0; l < sources.size(); ++l){
+                    output.push_back(data[l]);
+                }
+            }else{
+                const std::deque<double>& data = right_columns[c - left.size()]->data;
+                for(const AsofSource& source : sources){
+                    if(source.first == no_row){
+                        output.push_back(std::numeric_limits<double>::quiet_NaN());
+                    }else if(source.second == no_row){
+                        output.push_back(data[source.first]);
+                    }else{
+                        output.push_back((1.0 - source.weight) * data[source.first] + source.weight * data[source.second]);
+                    }
+                }
+            }
+        });
+        return result;
+    }
+
+}// namespace csvd
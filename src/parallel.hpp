@@ -0,0 +1,122 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+
+#include <csvd/csvd.hpp>
+
+/**
+ * @brief Marks a kernel to be compiled for multiple instruction sets
+ *
+ * The best version is selected at load time. Only enabled where the toolchain supports
+ * function multi-versioning (x86-64 ELF targets), everywhere else this is a no-op.
+ */
+#if defined(__x86_64__) && defined(__ELF__) && defined(__has_attribute)
+    #if __has_attribute(target_clones)
+        #define CSVD_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+    #endif
+#endif
+#ifndef CSVD_TARGET_CLONES
+    #define CSVD_TARGET_CLONES
+#endif
+
+namespace csvd::detail{
+
+    /// Number of values that are processed at once. Small enough to stay in the L1 cache.
+    inline constexpr size_t block_size = 1024;
+
+    /// Number of independent accumulators in the kernels. Enough to fill an AVX-512 register.
+    inline constexpr size_t lanes = 8;
+
+    /**
+     * @brief Returns the number of threads to use for `n` work items
+     */
+    [[nodiscard]] inline unsigned int thread_count(size_t n, const ParallelSettings& parallel){
+        const unsigned int hardware = (parallel.max_threads != 0) ? parallel.max_threads : std::max(1u, std::thread::hardware_concurrency());
+        const size_t by_size = (parallel.threshold != 0) ? (n / parallel.threshold) : n;
+        return static_cast<unsigned int>(std::clamp<size_t>(by_size, 1, hardware));
+    }
+
+    /**
+     * @brief Splits `[0, n)` into `parts` contiguous ranges and calls `function(part, first, last)` for each in parallel
+     *
+     * The first part runs on the calling thread. Returns after all parts have finished.
+     */
+    template<class Function>
+    void parallel_for(size_t n, unsigned int parts, Function&& function){
+        if(parts <= 1){
+            function(0u, size_t(0), n);
+            return;
+        }
+        std::vector<std::jthread> threads;
+        threads.reserve(parts - 1);
+        for(unsigned int part = 1; part < parts; ++part){
+            threads.emplace_back([&function, n, parts, part]{
+                function(part, n * part / parts, n * (part + 1) / parts);
+            });
+        }
+        function(0u, size_t(0), n / parts);
+    }
+
+    /**
+     * @brief Calls `function(values, count, offset)` on contiguous blocks of `data[first, last)`
+     *
+     * `std::deque` does not store its elements contiguously, which prevents vectorization.
+     * The blocks are copied into a small buffer that stays in the L1 cache so the kernels
+     * can work on plain arrays.
+     */
+    template<class Function>
+    void for_each_block(const std::deque<double>& data, size_t first, size_t last, Function&& function){
+        alignas(64) double buffer[block_size];
+        for(size_t offset = first; offset < last; offset += block_size){
+            const size_t count = std::min(block_size, last - offset);
+            const auto begin = data.begin() + offset;
+            std::copy(begin, begin + count, buffer);
+            function(static_cast<const double*>(buffer), count, offset);
+        }
+    }
+
+    /**
+     * @brief Same as `for_each_block` but iterates over two columns in lockstep
+     */
+    template<class Function>
+    void for_each_block(const std::deque<double>& a, const std::deque<double>& b, size_t first, size_t last, Function&& function){
+        alignas(64) double buffer_a[block_size];
+        alignas(64) double buffer_b[block_size];
+        for(size_t offset = first; offset < last; offset += block_size){
+            const size_t count = std::min(block_size, last - offset);
+            const auto begin_a = a.begin() + offset;
+            const auto begin_b = b.begin() + offset;
+            std::copy(begin_a, begin_a + count, buffer_a);
+            std::copy(begin_b, begin_b + count, buffer_b);
+            function(static_cast<const double*>(buffer_a), static_cast<const double*>(buffer_b), count, offset);
+        }
+    }
+
+    /**
+     * @brief Compensated (Neumaier) summation of a few partial results
+     */
+    class NeumaierSum{
+        public:
+            inline void add(double value){
+                const double t = this->sum_ + value;
+                if(std::abs(this->sum_) >= std::abs(value)){
+                    this->compensation_ += (this->sum_ - t) + value;
+                }else{
+                    this->compensation_ += (value - t) + this->sum_;
+                }
+                this->sum_ = t;
+            }
+
+            [[nodiscard]] inline double result() const {return this->sum_ + this->compensation_;}
+
+        private:
+            double sum_ = 0;
+            double compensation_ = 0;
+    };
+
+}// namespace csvd::detail
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <span>
+
+#include <csvd/expression.hpp>
+
+namespace csvd::detail{
+
+    enum class Op{
+        Constant,
+        Column,
+        Negate, Not, Abs, Sqrt, Exp, Log, Log10, Sin, Cos, Tan, Atan, Floor, Ceil, IsNaN,
+        Add, Subtract, Multiply, Divide, Pow, Atan2, Hypot, Min, Max,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, And, Or,
+        Where,
+    };
+
+    /**
+     * @brief A node of the expression tree. Nodes are immutable and shared between expressions.
+     */
+    struct ExprNode{
+        Op op;
+        double value = 0;       ///< for `Op::Constant`
+        std::string name;       ///< for `Op::Column`
+        std::array<std::shared_ptr<const ExprNode>, 3> children;
+    };
+
+    /**
+     * @brief An expression compiled into a flat list of instructions that operate on blocks of rows
+     *
+     * Every instruction runs one tight loop over up to `block_size` values, so a whole tree is
+     * evaluated block by block and the intermediate results stay in a few cache resident registers.
+     */
+    class Program{
+        public:
+
+            /**
+             * @param expression The expression to compile
+             * @param inputs The names of the input columns. The columns that the expression uses are appended if they are missing.
+             */
+            Program(const Expr& expression, std::vector<std::string>& inputs);
+
+            /**
+             * @brief Returns the working memory for `run`, one per thread
+             */
+            [[nodiscard]] std::vector<double> scratch() const;
+
+            /**
+             * @brief Evaluates `count <= block_size` rows
+             *
+             * @param inputs `inputs[i]` points to `count` values of the i-th input column
+             * @param count The number of rows
+             * @param scratch Working memory from `scratch()`
+             * @return The `count` results. Points into `scratch` or `inputs` and is valid until the next call.
+             */
+            [[nodiscard]] const double* run(std::span<const double* const> inputs, size_t count, std::vector<double>& scratch) const;
+
+        private:
+
+            struct Operand{
+                enum class Kind{Input, Register, Constant};
+                Kind kind;
+                size_t index;
+            };
+
+            struct Instruction{
+                Op op;
+                std::array<Operand, 3> arguments;
+                size_t output;
+            };
+
+            Operand compile(const ExprNode& node, std::vector<std::string>& inputs, std::vector<bool>& used);
+
+            std::vector<Instruction> instructions_;
+            std::vector<double> constants_;
+            size_t registers_ = 0;
+            Operand result_;
+    };
+
+}// namespace csvd::detail
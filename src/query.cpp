@@ -0,0 +1,278 @@
+#include <algorithm>
+
+#include <csvd/query.hpp>
+#include <csvd/reader.hpp>
+#include <csvd/writer.hpp>
+
+#include "parallel.hpp"
+#include "program.hpp"
+#include "groups.hpp"
+
+namespace csvd{
+
+    namespace {
+
+        /**
+         * @brief Where the values of a column come from while the query runs
+         */
+        struct Source{
+            bool derived;   ///< `true` for the result of a step, `false` for a converted column of the file
+            size_t index;   ///< The step or the buffer of the converted column
+        };
+
+    }// namespace
+
+    Query::Query(std::istream& stream, Settings settings)
+        : stream_(stream)
+        , settings_(std::move(settings))
+    {}
+
+    Query& Query::select(std::vector<std::string> columns){
+        this->selection_ = std::move(columns);
+        this->has_selection_ = true;
+        return *this;
+    }
+
+    Query& Query::filter(Expr condition){
+        this->steps_.push_back(Step{std::string(), std::move(condition), true});
+        return *this;
+    }
+
+    Query& Query::derive(std::string name, Expr expression){
+        this->steps_.push_back(Step{std::move(name), std::move(expression), false});
+        return *this;
+    }
+
+    std::vector<std::string> Query::output_names(const std::vector<std::string>& file_columns) const {
+        if(this->has_selection_){
+            return this->selection_;
+        }
+        std::vector<std::string> names = file_columns;
+        for(const Step& step : this->steps_){
+            if(step.is_filter == false && std::ranges::find(names, step.name) == names.end()){
+                names.push_back(step.name);
+            }
+        }
+        return names;
+    }
+
+    template<class Begin, class Emit>
+    tl::expected<void, ReadError> Query::run(const std::vector<std::string>* outputs, Begin&& begin, Emit&& emit){
+        Reader reader(this->stream_, this->settings_);
+        if(tl::expected<void, ReadError> header = reader.read_header(); header.has_value() == false){
+            return header;
+        }
+        const std::vector<std::string>& file_columns = reader.names();
+
+        // plan: resolve every name once, columns of the file are only converted if something uses them
+        std::vector<size_t> converted;
+        const auto resolve = [&](const std::string& name, size_t visible_steps) -> tl::expected<Source, ReadError> {
+            for(size_t s = visible_steps; s-- > 0;){
+                if(this->steps_[s].is_filter == false && this->steps_[s].name == name){
+                    return Source{true, s};
+                }
+            }
+            const auto column = std::ranges::find(file_columns, name);
+            if(column == file_columns.end()){
+                return tl::unexpected(ReadError(ErrorCase::UnknownColumn, name, {'\0'}, 0, reader.row(), '\0'));
+            }
+            const size_t index = static_cast<size_t>(column - file_columns.begin());
+            const auto buffer = std::ranges::find(converted, index);
+            if(buffer != converted.end()){
+                return Source{false, static_cast<size_t>(buffer - converted.begin())};
+            }
+            converted.push_back(index);
+            return Source{false, converted.size() - 1};
+        };
+
+        std::vector<detail::Program> programs;
+        std::vector<std::vector<Source>> step_sources(this->steps_.size());
+        for(size_t s = 0; s < this->steps_.size(); ++s){
+            std::vector<std::string> inputs;
+            programs.emplace_back(this->steps_[s].expression, inputs);
+            for(const std::string& input : inputs){
+                tl::expected<Source, ReadError> source = resolve(input, s);
+                if(source.has_value() == false){
+                    return tl::unexpected(source.error());
+                }
+                step_sources[s].push_back(source.value());
+            }
+        }
+
+        const std::vector<std::string> names = (outputs != nullptr) ? *outputs : this->output_names(file_columns);
+        std::vector<Source> output_sources;
+        for(const std::string& name : names){
+            tl::expected<Source, ReadError> source = resolve(name, this->steps_.size());
+            if(source.has_value() == false){
+                return tl::unexpected(source.error());
+            }
+            output_sources.push_back(source.value());
+        }
+
+        reader.select_columns(converted);
+        begin(names);
+
+        // execute: parse a chunk of rows, run every step on the whole chunk, emit the rows that passed all filters
+        std::vector<std::vector<double>> buffers(converted.size(), std::vector<double>(detail::block_size));
+        std::vector<std::vector<double>> scratches;
+        for(const detail::Program& program : programs){
+            scratches.push_back(program.scratch());
+        }
+        std::vector<const double*> results(programs.size(), nullptr);
+        std::vector<const double*> pointers;
+        std::vector<unsigned char> keep(detail::block_size);
+        std::vector<double> values(names.size());
+        const auto pointer = [&](const Source& source){
+            return source.derived ? results[source.index] : static_cast<const double*>(buffers[source.index].data());
+        };
+
+        bool end_of_file = false;
+        while(end_of_file == false){
+            size_t count = 0;
+            for(; count < detail::block_size; ++count){
+                tl::expected<bool, ReadError> has_row = reader.next_row();
+                if(has_row.has_value() == false){
+                    return tl::unexpected(has_row.error());
+                }
+                if(has_row.value() == false){
+                    end_of_file = true;
+                    break;
+                }
+                const std::span<const double> row = reader.values();
+                for(size_t b = 0; b < converted.size(); ++b){
+                    buffers[b][count] = row[converted[b]];
+                }
+            }
+            if(count == 0){
+                break;
+            }
+
+            std::fill(keep.begin(), keep.begin() + static_cast<std::ptrdiff_t>(count), 1);
+            for(size_t s = 0; s < programs.size(); ++s){
+                pointers.clear();
+                for(const Source& source : step_sources[s]){
+                    pointers.push_back(pointer(source));
+                }
+                results[s] = programs[s].run(pointers, count, scratches[s]);
+                if(this->steps_[s].is_filter){
+                    for(size_t i = 0; i < count; ++i){
+                        keep[i] &= static_cast<unsigned char>(results[s][i] != 0);
+                    }
+                }
+            }
+
+            for(size_t i = 0; i < count; ++i){
+                if(keep[i]){
+                    for(size_t o = 0; o < output_sources.size(); ++o){
+                        values[o] = pointer(output_sources[o])[i];
+                    }
+                    emit(std::span<const double>(values));
+                }
+            }
+        }
+        return {};
+    }
+
+    tl::expected<CSVd, ReadError> Query::collect(){
+        CSVd result(this->settings_);
+        tl::expected<void, ReadError> done = this->run(nullptr,
+            [&](const std::vector<std::string>& names){
+                for(const std::string& name : names){
+                    Column column;
+                    column.name = name;
+                    result.push_back(std::move(column));
+                }
+            },
+            [&](std::span<const double> values){
+                for(size_t c = 0; c < values.size(); ++c){
+                    result[c].push_back(values[c]);
+                }
+            });
+        if(done.has_value() == false){
+            return tl::unexpected(done.error());
+        }
+        return result;
+    }
+
+    tl::expected<void, ReadError> Query::write(std::ostream& stream){
+        Writer writer(stream, this->settings_);
+        return this->run(nullptr,
+            [&](const std::vector<std::string>& names){writer.write_header(names);},
+            [&](std::span<const double> values){writer.write_row(values);});
+    }
+
+    tl::expected<CSVd, ReadError> Query::aggregate(std::vector<std::string> keys, const std::vector<Aggregation>& aggregations){
+        // the output of the pipeline are the keys followed by every value column once
+        std::vector<std::string> outputs = keys;
+        std::vector<size_t> value_of_aggregation;
+        for(const Aggregation& aggregation : aggregations){
+            const auto found = std::find(outputs.begin() + static_cast<std::ptrdiff_t>(keys.size()), outputs.end(), aggregation.column);
+            value_of_aggregation.push_back(static_cast<size_t>(found - outputs.begin()) - keys.size());
+            if(found == outputs.end()){
+                outputs.push_back(aggregation.column);
+            }
+        }
+
+        const size_t key_count = keys.size();
+        detail::GroupTable table(key_count, outputs.size() - key_count);
+        std::vector<std::uint64_t> key(key_count);
+        tl::expected<void, ReadError> done = this->run(&outputs,
+            [](const std::vector<std::string>&){},
+            [&](std::span<const double> values){
+                for(size_t k = 0; k < key_count; ++k){
+                    key[k] = detail::key_bits(values[k]);
+                }
+                detail::Accumulator* accumulators = table.groups().accumulators(table.insert(key.data()));
+                for(size_t v = key_count; v < values.size(); ++v){
+                    accumulators[v - key_count].push(values[v]);
+                }
+            });
+        if(done.has_value() == false){
+            return tl::unexpected(done.error());
+        }
+        return detail::group_table(table.groups(), keys, aggregations, value_of_aggregation, this->settings_);
+    }
+
+    tl::expected<std::optional<FoundRow>, ReadError> find_first_row(std::istream& stream, const Expr& predicate, Settings settings){
+        Reader reader(stream, std::move(settings));
+        if(tl::expected<void, ReadError> header = reader.read_header(); header.has_value() == false){
+            return tl::unexpected(header.error());
+        }
+
+        std::vector<std::string> inputs;
+        const detail::Program program(predicate, inputs);
+        std::vector<size_t> columns;
+        for(const std::string& name : inputs){
+            const auto column = std::ranges::find(reader.names(), name);
+            if(column == reader.names().end()){
+                return tl::unexpected(ReadError(ErrorCase::UnknownColumn, name, {'\0'}, 0, reader.row(), '\0'));
+            }
+            columns.push_back(static_cast<size_t>(column - reader.names().begin()));
+        }
+        reader.select_columns(columns);
+
+        // evaluated row by row, so nothing after the match is parsed
+        std::vector<double> scratch = program.scratch();
+        std::vector<const double*> pointers(columns.size());
+        while(true){
+            tl::expected<bool, ReadError> has_row = reader.next_row();
+            if(has_row.has_value() == false){
+                return tl::unexpected(has_row.error());
+            }
+            if(has_row.value() == false){
+                return std::nullopt;
+            }
+            const std::span<const double> values = reader.values();
+            for(size_t i = 0; i < columns.size(); ++i){
+                pointers[i] = &values[columns[i]];
+            }
+            if(*program.run(pointers, 1, scratch) != 0){
+                if(tl::expected<void, ReadError> converted = reader.convert_remaining(); converted.has_value() == false){
+                    return tl::unexpected(converted.error());
+                }
+                return FoundRow{reader.row(), std::vector<double>(values.begin(), values.end())};
+            }
+        }
+    }
+
+}// namespace csvd
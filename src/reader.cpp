@@ -0,0 +1,563 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cctype>
+#include <functional>
+#include <limits>
+#include <string>
+
+#include <csvd/reader.hpp>
+
+#include "stats.hpp"
+
+#include <tl/expected.hpp>
+
+namespace csvd{
+
+    namespace {
+
+        /// Character classes used to scan lines and cells
+        constexpr unsigned char value_separator_class = 1;
+        constexpr unsigned char line_separator_class = 2;
+        constexpr unsigned char quote_class = 4;
+
+        /// Cells with more characters are rejected with `ErrorCase::CellTooLong`
+        constexpr size_t max_cell_length = 128;
+
+        /// Number of bytes that are requested from the stream at once
+        constexpr size_t read_block_size = size_t(1) << 16;
+
+        constexpr std::string_view whitespaces(" \a\b\t\n\v\f\r");
+
+        [[nodiscard]] std::string_view trim(std::string_view string, std::string_view trim_chars){
+            const std::string::size_type pos1 = string.find_first_not_of(trim_chars);
+            const std::string::size_type pos2 = string.find_last_not_of(trim_chars);
+            const std::string::size_type count = pos2 - pos1 + 1;
+
+            if(pos1 == std::string_view::npos){
+                return std::string_view("", 0);
+            }else if(pos2 == std::string::npos){
+                return string.substr(pos1);
+            }else{
+                return string.substr(pos1, count);
+            }
+        }
+
+        [[nodiscard]] std::string_view trim_whitespaces(std::string_view string){
+            return trim(string, whitespaces);
+        }
+
+        [[nodiscard]] bool is_blank(std::string_view line){
+            return line.find_first_not_of(whitespaces) == std::string_view::npos;
+        }
+
+        [[nodiscard]] std::string_view to_string_view(const std::array<char, 8>& characters){
+            const auto end = std::ranges::find(characters, '\0');
+            return std::string_view(characters.data(), static_cast<size_t>(end - characters.begin()));
+        }
+
+    }// namespace
+
+    Reader::Reader(std::istream& stream, Settings settings)
+        : stream_(stream)
+        , settings_(std::move(settings))
+    {
+        for(char c : to_string_view(this->settings_.value_separators)){
+            this->char_class_[static_cast<unsigned char>(c)] |= value_separator_class;
+        }
+        for(char c : to_string_view(this->settings_.line_separators)){
+            this->char_class_[static_cast<unsigned char>(c)] |= line_separator_class;
+        }
+        for(char c : to_string_view(this->settings_.quotes)){
+            this->char_class_[static_cast<unsigned char>(c)] |= quote_class;
+        }
+        const std::string_view line_separators = to_string_view(this->settings_.line_separators);
+        if(line_separators.size() == 1){
+            this->single_line_separator_ = line_separators.front();
+        }
+        // byte offsets are absolute if the stream is seekable
+        const std::istream::pos_type position = this->stream_.tellg();
+        if(position != std::istream::pos_type(-1)){
+            this->consumed_ = static_cast<std::uint64_t>(position);
+        }
+    }
+
+    void Reader::set_control(ReadControl control){
+        this->control_ = std::move(control);
+        this->has_control_ = static_cast<bool>(this->control_.progress) || this->control_.stop_token.stop_possible();
+        this->progress_ = ReadProgress();
+        this->next_bytes_report_ = this->control_.bytes_interval;
+        this->next_rows_report_ = this->control_.rows_interval;
+        this->reported_end_ = false;
+        if(this->control_.progress){
+            const std::istream::pos_type position = this->stream_.tellg();
+            if(position != std::istream::pos_type(-1)){
+                this->stream_.seekg(0, std::ios::end);
+                const std::istream::pos_type end = this->stream_.tellg();
+                this->stream_.seekg(position);
+                if(end != std::istream::pos_type(-1)){
+                    this->progress_.total = static_cast<size_t>(end - position);
+                }
+            }
+        }
+    }
+
+    void Reader::report_progress(){
+        if(this->control_.progress){
+            this->control_.progress(this->progress_);
+        }
+        this->next_bytes_report_ = this->progress_.bytes + this->control_.bytes_interval;
+        this->next_rows_report_ = this->progress_.rows + this->control_.rows_interval;
+    }
+
+    bool Reader::fill(){
+        if(this->stream_end_){
+            return false;
+        }
+        if(this->buffer_.empty()){
+            this->buffer_.resize(read_block_size);
+            if constexpr (detail::stats_enabled){
+                if(this->stats_ != nullptr){
+                    ++this->stats_->allocations;
+                }
+            }
+        }
+        this->stream_.read(this->buffer_.data(), static_cast<std::streamsize>(this->buffer_.size()));
+        const size_t count = static_cast<size_t>(this->stream_.gcount());
+        if constexpr (detail::stats_enabled){
+            if(this->stats_ != nullptr){
+                this->stats_->recorded = true;
+                this->stats_->bytes += count;
+            }
+        }
+        if(count < this->buffer_.size()){
+            this->stream_end_ = true;
+        }
+        if(this->has_control_){
+            this->progress_.bytes += count;
+            if(this->control_.bytes_interval != 0 && this->progress_.bytes >= this->next_bytes_report_){
+                this->report_progress();
+            }
+        }
+        this->consumed_ += this->end_;
+        this->position_ = 0;
+        this->end_ = count;
+        return count != 0;
+    }
+
+    size_t Reader::memory() const {
+        return this->buffer_.capacity() + this->carry_.capacity()
+            + this->cells_.capacity() * sizeof(std::string_view) + this->values_.capacity() * sizeof(double);
+    }
+
+    tl::expected<bool, ReadError> Reader::next_line(std::string_view& line, char& separator){
+        bool carrying = false;
+        std::uint64_t line_start = 0;
+        while(true){
+            if(this->position_ == this->end_){
+                const bool has_data = this->fill();
+                if(this->stream_.bad()){
+                    return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, 0, this->lines_, '\0'));
+                }
+                if(this->has_control_ && this->control_.stop_token.stop_requested()){
+                    return tl::unexpected(ReadError(ErrorCase::Cancelled, "", {'\0'}, 0, this->lines_, '\0'));
+                }
+                if(has_data == false){
+                    // last line without a line separator
+                    if(carrying && (this->carry_.empty() == false)){
+                        line = this->carry_;
+                        separator = '\0';
+                        this->row_ = this->lines_++;
+                        this->line_offset_ = line_start;
+                        return true;
+                    }
+                    return false;
+                }
+            }
+
+            if(carrying == false){
+                line_start = this->consumed_ + this->position_;
+            }
+            const char* first = this->buffer_.data() + this->position_;
+            const char* last = this->buffer_.data() + this->end_;
+            const char* found = last;
+            if(this->single_line_separator_ != '\0'){
+                const void* match = std::memchr(first, this->single_line_separator_, static_cast<size_t>(last - first));
+                if(match != nullptr){
+                    found = static_cast<const char*>(match);
+                }
+            }else{
+                found = std::find_if(first, last, [this](char c){
+                    return (this->char_class_[static_cast<unsigned char>(c)] & line_separator_class) != 0;
+                });
+            }
+
+            if(found != last){
+                this->position_ = static_cast<size_t>(found - this->buffer_.data()) + 1;
+                separator = *found;
+                if(carrying){
+                    this->carry_.append(first, found);
+                    line = this->carry_;
+                }else{
+                    line = std::string_view(first, found);
+                }
+                this->row_ = this->lines_++;
+                this->line_offset_ = line_start;
+                return true;
+            }
+
+            // the line continues in the next block
+            if(carrying == false){
+                this->carry_.clear();
+                carrying = true;
+            }
+            const size_t carry_capacity = this->carry_.capacity();
+            this->carry_.append(first, last);
+            if constexpr (detail::stats_enabled){
+                if(this->stats_ != nullptr && this->carry_.capacity() != carry_capacity){
+                    ++this->stats_->allocations;
+                }
+            }
+            this->position_ = this->end_;
+        }
+    }
+
+    tl::expected<void, ReadError> Reader::read_header(){
+        if(this->stream_.eof()){
+            return tl::unexpected(ReadError(ErrorCase::UnexpectedEof, "", {'\0'}, 0, 0, '\0'));
+        }
+        if(this->stream_.bad()){
+            return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, 0, 0, '\0'));
+        }
+
+        // skip leading empty lines
+        std::string_view line;
+        char separator = '\0';
+        do{
+            tl::expected<bool, ReadError> has_line = this->next_line(line, separator);
+            if(has_line.has_value() == false){
+                return tl::unexpected(has_line.error());
+            }
+            if(has_line.value() == false){
+                // empty file
+                return {};
+            }
+        }while(is_blank(line));
+
+        HeaderType header_type = this->settings_.header_type;
+        if(header_type == HeaderType::Auto){
+            const char first = line[line.find_first_not_of(whitespaces)];
+            if(std::isdigit(static_cast<unsigned char>(first)) || first == '+' || first == '-'){
+                // detected numeric data in the first row --> no header
+                header_type = HeaderType::None;
+            }else{
+                // detected non-numeric string in the first row --> has header
+                header_type = HeaderType::FirstRow;
+            }
+        }
+
+        // split the first line into cells
+        this->line_ = line;
+        const std::string_view quotes = to_string_view(this->settings_.quotes);
+        const char* itr = line.data();
+        const char* const end = line.data() + line.size();
+        while(true){
+            const char* cell_first = itr;
+            bool is_in_quote = false;
+            for(; itr != end; ++itr){
+                const unsigned char char_class = this->char_class_[static_cast<unsigned char>(*itr)];
+                if(char_class & quote_class){
+                    is_in_quote = !is_in_quote;
+                }else if((char_class & value_separator_class) && (is_in_quote == false)){
+                    break;
+                }
+            }
+
+            const std::string_view raw(cell_first, static_cast<size_t>(itr - cell_first));
+            if(raw.size() > max_cell_length){
+                return tl::unexpected(ReadError(ErrorCase::CellTooLong, raw, {'\0'}, this->names_.size(), this->row_, (itr != end) ? *itr : separator, this->line_offset_, this->offset_of(raw)));
+            }
+
+            std::string_view cell = trim_whitespaces(raw);
+            if(this->settings_.auto_quotes){
+                cell = trim(cell, quotes);
+            }
+            this->names_.emplace_back((header_type == HeaderType::FirstRow) ? cell : std::string_view());
+
+            if(itr == end){
+                break;
+            }
+            ++itr; // consume the value separator
+        }
+
+        this->cells_.resize(this->names_.size());
+        this->values_.resize(this->names_.size());
+        this->convert_.assign(this->names_.size(), 1);
+
+        tl::expected<void, ReadError> resolved = this->resolve_predicates();
+        if(resolved.has_value() == false){
+            return resolved;
+        }
+
+        if(header_type == HeaderType::None){
+            // the first line is a data row, hand it out with the next call to `next_row()`
+            this->pending_line_ = line;
+            this->pending_line_offset_ = this->line_offset_;
+            this->pending_separator_ = separator;
+            this->has_pending_line_ = true;
+        }
+        return {};
+    }
+
+    tl::expected<void, ReadError> Reader::resolve_predicates(){
+        this->has_predicate_.assign(this->columns(), 0);
+        this->bounds_.assign(this->columns(), Bounds{-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()});
+
+        for(const RowPredicate& predicate : this->settings_.row_predicates){
+            size_t index = predicate.index;
+            if(predicate.column.empty() == false){
+                const auto found = std::ranges::find(this->names_, predicate.column);
+                if(found == this->names_.end()){
+                    return tl::unexpected(ReadError(ErrorCase::UnknownColumn, predicate.column, {'\0'}, 0, this->row_, '\0'));
+                }
+                index = static_cast<size_t>(found - this->names_.begin());
+            }else if(index >= this->columns()){
+                return tl::unexpected(ReadError(ErrorCase::UnknownColumn, std::to_string(index), {'\0'}, index, this->row_, '\0'));
+            }
+
+            // multiple predicates on the same column intersect
+            this->has_predicate_[index] = 1;
+            this->bounds_[index].min = std::max(this->bounds_[index].min, predicate.min);
+            this->bounds_[index].max = std::min(this->bounds_[index].max, predicate.max);
+        }
+        return {};
+    }
+
+    void Reader::select_columns(std::span<const size_t> columns){
+        this->convert_.assign(this->columns(), 0);
+        for(const size_t column : columns){
+            if(column < this->columns()){
+                this->convert_[column] = 1;
+            }
+        }
+        this->reset_skipped_values();
+    }
+
+    void Reader::reset_skipped_values(){
+        for(size_t column = 0; column < this->columns(); ++column){
+            if(this->convert_[column] == 0){
+                this->values_[column] = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+        this->has_skipped_values_ = false;
+    }
+
+    tl::expected<void, ReadError> Reader::convert(std::string_view cell, size_t column){
+        const std::string_view quotes = to_string_view(this->settings_.quotes);
+        if(this->settings_.auto_quotes && (cell.empty() == false) && (quotes.find(cell.front()) != std::string_view::npos)){
+            cell = trim(cell, quotes);
+        }
+        const std::from_chars_result result = std::from_chars(cell.data(), cell.data() + cell.size(), this->values_[column]);
+        if(result.ec != std::errc{}){
+            return tl::unexpected(ReadError(ErrorCase::ErrorParsingFloat, cell, {'\0'}, column, this->row_, '\0', this->line_offset_, this->offset_of(cell)));
+        }
+        return {};
+    }
+
+    tl::expected<void, ReadError> Reader::convert_remaining(){
+        for(size_t column = 0; column < this->columns(); ++column){
+            if(this->convert_[column] == 0 && this->has_predicate_[column] == 0){
+                tl::expected<void, ReadError> converted = this->convert(this->cells_[column], column);
+                if(converted.has_value() == false){
+                    return converted;
+                }
+                this->has_skipped_values_ = true;
+            }
+        }
+        return {};
+    }
+
+    tl::expected<bool, ReadError> Reader::next_row(){
+        while(true){
+            if constexpr (detail::stats_enabled){
+                if(this->stats_ != nullptr){
+                    this->phase_start_ = detail::stats_now();
+                }
+            }
+            std::string_view line;
+            char separator = '\0';
+            if(this->has_pending_line_){
+                line = this->pending_line_;
+                this->line_offset_ = this->pending_line_offset_;
+                separator = this->pending_separator_;
+                this->has_pending_line_ = false;
+            }else{
+                tl::expected<bool, ReadError> has_line = this->next_line(line, separator);
+                if(has_line.has_value() == false){
+                    return tl::unexpected(has_line.error());
+                }
+                if(has_line.value() == false){
+                    // the final report, after all rows have been counted
+                    if(this->has_control_ && this->reported_end_ == false){
+                        this->reported_end_ = true;
+                        this->report_progress();
+                    }
+                    return false;
+                }
+            }
+
+            if(is_blank(line)){
+                continue;
+            }
+
+            tl::expected<bool, ReadError> kept = this->parse_row(line, separator);
+            if(kept.has_value() == false && this->settings_.bad_rows != BadRows::Fail){
+                if(this->tolerate(kept.error()) == false){
+                    return kept;
+                }
+                if(this->settings_.bad_rows == BadRows::Skip){
+                    continue;
+                }
+                std::ranges::fill(this->values_, std::numeric_limits<double>::quiet_NaN());
+                // the cells behind the bad one still point into earlier lines
+                std::ranges::fill(this->cells_, std::string_view("nan"));
+                kept = true;
+            }
+            if(kept.has_value() && kept.value() == true && this->has_control_){
+                ++this->progress_.rows;
+                if(this->control_.rows_interval != 0 && this->progress_.rows >= this->next_rows_report_){
+                    if(this->control_.stop_token.stop_requested()){
+                        return tl::unexpected(ReadError(ErrorCase::Cancelled, "", {'\0'}, 0, this->row_, '\0'));
+                    }
+                    this->report_progress();
+                }
+            }
+            if(kept.has_value() == false || kept.value() == true){
+                return kept;
+            }
+            // the row failed a predicate, continue with the next line
+        }
+    }
+
+    std::uint64_t Reader::offset_of(std::string_view text) const {
+        const char* const first = this->line_.data();
+        const char* const last = first + this->line_.size();
+        if(std::less<const char*>{}(text.data(), first) || std::less<const char*>{}(last, text.data())){
+            // e.g. an empty cell that does not point into the line
+            return this->line_offset_;
+        }
+        return this->line_offset_ + static_cast<std::uint64_t>(text.data() - first);
+    }
+
+    bool Reader::tolerate(const ReadError& error){
+        switch(error.error_case()){
+            break; case ErrorCase::ErrorParsingFloat:
+            case ErrorCase::CellTooLong:
+            case ErrorCase::UnexpectedLineSeparator:
+            case ErrorCase::ExpectedLineSeparator:
+                if(this->errors_.size() >= this->settings_.max_errors){
+                    return false;
+                }
+                this->errors_.push_back(error);
+                return true;
+            break; default:
+                // the stream or the settings are broken, not the row
+                return false;
+        }
+    }
+
+    tl::expected<bool, ReadError> Reader::parse_row(std::string_view line, char separator){
+        const size_t columns = this->columns();
+        if(columns == 0){
+            return tl::unexpected(ReadError(ErrorCase::CellOutOfRange, trim_whitespaces(line), {'\0'}, 0, this->row_, separator, this->line_offset_));
+        }
+
+        if(this->has_skipped_values_){
+            this->reset_skipped_values();
+        }
+        this->line_ = line;
+
+        // split the line, predicate columns are converted and tested right away
+        const char* itr = line.data();
+        const char* const end = line.data() + line.size();
+        for(size_t column = 0; ; ++column){
+            const char* cell_first = itr;
+            bool is_in_quote = false;
+            for(; itr != end; ++itr){
+                const unsigned char char_class = this->char_class_[static_cast<unsigned char>(*itr)];
+                if(char_class & quote_class){
+                    is_in_quote = !is_in_quote;
+                }else if((char_class & value_separator_class) && (is_in_quote == false)){
+                    break;
+                }
+            }
+
+            const std::string_view raw(cell_first, static_cast<size_t>(itr - cell_first));
+            const char peek = (itr != end) ? *itr : separator;
+            if(raw.size() > max_cell_length){
+                return tl::unexpected(ReadError(ErrorCase::CellTooLong, raw, {'\0'}, column, this->row_, peek, this->line_offset_, this->offset_of(raw)));
+            }
+            const std::string_view cell = trim_whitespaces(raw);
+            this->cells_[column] = cell;
+
+            if(this->has_predicate_[column]){
+                tl::expected<void, ReadError> converted = this->convert(cell, column);
+                if(converted.has_value() == false){
+                    return tl::unexpected(converted.error());
+                }
+                const double value = this->values_[column];
+                if(!(this->bounds_[column].min <= value && value <= this->bounds_[column].max)){
+                    if constexpr (detail::stats_enabled){
+                        if(this->stats_ != nullptr){
+                            this->stats_->scan += detail::stats_now() - this->phase_start_;
+                            this->stats_->rows += 1;
+                            this->stats_->cells += column + 1;
+                        }
+                    }
+                    // skip the rest of the row
+                    return false;
+                }
+            }
+
+            if(itr == end){
+                if(column + 1 != columns){
+                    return tl::unexpected(ReadError(ErrorCase::UnexpectedLineSeparator, cell, this->settings_.value_separators, column, this->row_, peek, this->line_offset_, this->offset_of(raw)));
+                }
+                break;
+            }
+
+            if(column + 1 == columns){
+                return tl::unexpected(ReadError(ErrorCase::ExpectedLineSeparator, cell, this->settings_.line_separators, column, this->row_, peek, this->line_offset_, this->offset_of(raw)));
+            }
+            ++itr; // consume the value separator
+        }
+
+        if constexpr (detail::stats_enabled){
+            if(this->stats_ != nullptr){
+                const auto now = detail::stats_now();
+                this->stats_->scan += now - this->phase_start_;
+                this->phase_start_ = now;
+                this->stats_->rows += 1;
+                this->stats_->cells += columns;
+            }
+        }
+
+        // convert the remaining cells of the accepted row
+        for(size_t column = 0; column < columns; ++column){
+            if(this->has_predicate_[column] == 0 && this->convert_[column]){
+                tl::expected<void, ReadError> converted = this->convert(this->cells_[column], column);
+                if(converted.has_value() == false){
+                    return tl::unexpected(converted.error());
+                }
+            }
+        }
+
+        if constexpr (detail::stats_enabled){
+            if(this->stats_ != nullptr){
+                this->stats_->convert += detail::stats_now() - this->phase_start_;
+            }
+        }
+        return true;
+    }
+
+}// namespace csvd
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+#include <csvd/resample.hpp>
+
+#include "parallel.hpp"
+#include "columns.hpp"
+
+namespace csvd{
+
+    namespace {
+
+        CSVD_TARGET_CLONES
+        void lerp_kernel(const double* a, const double* b, size_t count, double weight, double* output){
+            for(size_t i = 0; i < count; ++i){
+                output[i] = a[i] + weight * (b[i] - a[i]);
+            }
+        }
+
+        CSVD_TARGET_CLONES
+        void add_kernel(double* sum, const double* row, size_t count){
+            for(size_t i = 0; i < count; ++i){
+                sum[i] += row[i];
+            }
+        }
+
+        CSVD_TARGET_CLONES
+        void scale_kernel(double* values, size_t count, double factor){
+            for(size_t i = 0; i < count; ++i){
+                values[i] *= factor;
+            }
+        }
+
+        [[nodiscard]] CSVd empty_table(const std::vector<std::string>& names, const Settings& settings){
+            CSVd result(settings);
+            for(const std::string& name : names){
+                Column column;
+                column.name = name;
+                result.push_back(std::move(column));
+            }
+            return result;
+        }
+
+        [[nodiscard]] std::vector<std::string> names_of(const CSVd& table){
+            std::vector<std::string> names;
+            for(const Column& column : table){
+                names.push_back(column.name);
+            }
+            return names;
+        }
+
+        /**
+         * @brief Calls `function(row)` for every complete row of the table
+         */
+        template<class Function>
+        void for_each_row(const CSVd& table, Function&& function){
+            const size_t rows = detail::row_count(table);
+            std::vector<std::deque<double>::const_iterator> iterators;
+            for(const Column& column : table){
+                iterators.push_back(column.data.begin());
+            }
+            std::vector<double> row(table.size());
+            for(size_t r = 0; r < rows; ++r){
+                for(size_t c = 0; c < iterators.size(); ++c){
+                    row[c] = *iterators[c]++;
+                }
+                function(std::span<const double>(row));
+            }
+        }
+
+        /**
+         * @brief Calls `function(row)` for every remaining row of the reader
+         */
+        template<class Function>
+        [[nodiscard]] tl::expected<void, ReadError> for_each_row(Reader& reader, Function&& function){
+            while(true){
+                tl::expected<bool, ReadError> result = reader.next_row();
+                if(result.has_value() == false){
+                    return tl::unexpected(result.error());
+                }
+                if(result.value() == false){
+                    return {};
+                }
+                function(reader.values());
+            }
+        }
+
+        [[nodiscard]] tl::expected<size_t, ReadError> axis_index(const Reader& reader, std::string_view axis){
+            const auto found = std::ranges::find(reader.names(), axis);
+            if(found == reader.names().end()){
+                return tl::unexpected(ReadError(ErrorCase::UnknownColumn, axis, {'\0'}, 0, reader.row(), '\0'));
+            }
+            return static_cast<size_t>(found - reader.names().begin());
+        }
+
+    }// namespace
+
+    std::vector<double> uniform_grid(double first, double last, size_t count){
+        std::vector<double> grid(count);
+        for(size_t i = 0; i < count; ++i){
+            grid[i] = (count == 1) ? first : first + (last - first) * static_cast<double>(i) / static_cast<double>(count - 1);
+        }
+        if(count > 1){
+            grid.back() = last;
+        }
+        return grid;
+    }
+
+    std::vector<double> logarithmic_grid(double first, double last, size_t count){
+        if((first > 0) == false || (last > 0) == false){
+            throw std::invalid_argument("csvd: logarithmic_grid requires positive bounds");
+        }
+        std::vector<double> grid = uniform_grid(std::log(first), std::log(last), count);
+        for(double& point : grid){
+            point = std::exp(point);
+        }
+        if(count > 0){
+            grid.front() = first;
+        }
+        if(count > 1){
+            grid.back() = last;
+        }
+        return grid;
+    }
+
+    Resampler::Resampler(std::vector<std::string> names, size_t axis, std::vector<double> grid, Interpolation interpolation, const Settings& settings)
+        : result_(empty_table(names, settings))
+        , axis_(axis)
+        , grid_(std::move(grid))
+        , interpolation_(interpolation)
+        , output_(names.size())
+    {
+        if(axis >= names.size()){
+            throw std::invalid_argument("csvd: the axis of the resampler is not a column");
+        }
+        if(std::ranges::is_sorted(this->grid_) == false){
+            throw std::invalid_argument("csvd: the resampling grid has to be sorted ascending");
+        }
+    }
+
+    void Resampler::emit_row(double x, std::span<const double> row){
+        for(size_t c = 0; c < this->result_.size(); ++c){
+            this->result_[c].push_back((c == this->axis_) ? x : row[c]);
+        }
+    }
+
+    void Resampler::emit_nan(double x){
+        std::ranges::fill(this->output_, std::numeric_limits<double>::quiet_NaN());
+        this->emit_row(x, this->output_);
+    }
+
+    void Resampler::push(std::span<const double> row){
+        const double t = row[this->axis_];
+        if(std::isnan(t)){
+            return;
+        }
+        if(this->previous_.empty() == false && t < this->previous_[this->axis_]){
+            throw std::invalid_argument("csvd: the axis has to be sorted ascending for resampling");
+        }
+
+        // all grid points up to the previous row have been emitted, so `previous < x <= t`
+        for(; this->next_ < this->grid_.size() && this->grid_[this->next_] <= t; ++this->next_){
+            const double x = this->grid_[this->next_];
+            if(x == t){
+                this->emit_row(x, row);
+            }else if(this->previous_.empty()){
+                this->emit_nan(x);
+            }else{
+                const double t0 = this->previous_[this->axis_];
+                switch(this->interpolation_){
+                    break; case Interpolation::Linear:{
+                        lerp_kernel(this->previous_.data(), row.data(), row.size(), (x - t0) / (t - t0), this->output_.data());
+                        this->emit_row(x, this->output_);
+                    }
+                    break; case Interpolation::Nearest:{
+                        this->emit_row(x, ((x - t0) <= (t - x)) ? std::span<const double>(this->previous_) : row);
+                    }
+                    break; case Interpolation::ZeroOrderHold:{
+                        this->emit_row(x, this->previous_);
+                    }
+                }
+            }
+        }
+        this->previous_.assign(row.begin(), row.end());
+    }
+
+    CSVd Resampler::finish(){
+        for(; this->next_ < this->grid_.size(); ++this->next_){
+            this->emit_nan(this->grid_[this->next_]);
+        }
+        return std::move(this->result_);
+    }
+
+    Decimator::Decimator(std::vector<std::string> names, size_t factor, const Settings& settings)
+        : result_(empty_table(names, settings))
+        , factor_(factor)
+        , sum_(names.size(), 0.0)
+    {
+        if(factor == 0){
+            throw std::invalid_argument("csvd: the decimation factor has to be positive");
+        }
+    }
+
+    void Decimator::push(std::span<const double> row){
+        add_kernel(this->sum_.data(), row.data(), this->sum_.size());
+        if(++this->count_ == this->factor_){
+            this->emit();
+        }
+    }
+
+    void Decimator::emit(){
+        scale_kernel(this->sum_.data(), this->sum_.size(), 1.0 / static_cast<double>(this->count_));
+        for(size_t c = 0; c < this->sum_.size(); ++c){
+            this->result_[c].push_back(this->sum_[c]);
+        }
+        std::ranges::fill(this->sum_, 0.0);
+        this->count_ = 0;
+    }
+
+    CSVd Decimator::finish(){
+        if(this->count_ > 0){
+            this->emit();
+        }
+        return std::move(this->result_);
+    }
+
+    CSVd resample(const CSVd& table, std::string_view axis, std::vector<double> grid, Interpolation interpolation){
+        const size_t index = detail::column_index(table, axis);
+        Resampler resampler(names_of(table), index, std::move(grid), interpolation, table.settings());
+        for_each_row(table, [&](std::span<const double> row){resampler.push(row);});
+        return resampler.finish();
+    }
+
+    tl::expected<CSVd, ReadError> resample(Reader& reader, std::string_view axis, std::vector<double> grid, Interpolation interpolation){
+        if(tl::expected<void, ReadError> header = reader.read_header(); header.has_value() == false){
+            return tl::unexpected(header.error());
+        }
+        const tl::expected<size_t, ReadError> index = axis_index(reader, axis);
+        if(index.has_value() == false){
+            return tl::unexpected(index.error());
+        }
+        Resampler resampler(reader.names(), index.value(), std::move(grid), interpolation, reader.settings());
+        if(tl::expected<void, ReadError> rows = for_each_row(reader, [&](std::span<const double> row){resampler.push(row);}); rows.has_value() == false){
+            return tl::unexpected(rows.error());
+        }
+        return resampler.finish();
+    }
+
+    CSVd decimate(const CSVd& table, size_t factor){
+        Decimator decimator(names_of(table), factor, table.settings());
+        for_each_row(table, [&](std::span<const double> row){decimator.push(row);});
+        return decimator.finish();
+    }
+
+    tl::expected<CSVd, ReadError> decimate(Reader& reader, size_t factor){
+        if(tl::expected<void, ReadError> header = reader.read_header(); header.has_value() == false){
+            return tl::unexpected(header.error());
+        }
+        Decimator decimator(reader.names(), factor, reader.settings());
+        if(tl::expected<void, ReadError> rows = for_each_row(reader, [&](std::span<const double> row){decimator.push(row);}); rows.has_value() == false){
+            return tl::unexpected(rows.error());
+        }
+        return decimator.finish();
+    }
+
+}// namespace csvd
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <string_view>
+
+#include <csvd/rewrite.hpp>
+#include <csvd/reader.hpp>
+#include <csvd/writer.hpp>
+
+namespace csvd{
+
+    tl::expected<void, ReadError> rewrite(std::istream& input, std::ostream& output, const std::vector<std::string>& columns, Settings input_settings, Settings output_settings){
+        Reader reader(input, std::move(input_settings));
+        if(tl::expected<void, ReadError> header = reader.read_header(); header.has_value() == false){
+            return header;
+        }
+
+        std::vector<size_t> indices;
+        std::vector<std::string> names;
+        if(columns.empty()){
+            for(size_t c = 0; c < reader.columns(); ++c){
+                indices.push_back(c);
+            }
+            names = reader.names();
+        }else{
+            for(const std::string& name : columns){
+                const auto found = std::ranges::find(reader.names(), name);
+                if(found == reader.names().end()){
+                    return tl::unexpected(ReadError(ErrorCase::UnknownColumn, name, {'\0'}, 0, reader.row(), '\0'));
+                }
+                indices.push_back(static_cast<size_t>(found - reader.names().begin()));
+            }
+            names = columns;
+        }
+
+        // the cells are only split, never converted
+        reader.select_columns({});
+
+        Writer writer(output, std::move(output_settings));
+        writer.write_header(names);
+        std::vector<std::string_view> cells(indices.size());
+        while(true){
+            tl::expected<bool, ReadError> has_row = reader.next_row();
+            if(has_row.has_value() == false){
+                return tl::unexpected(has_row.error());
+            }
+            if(has_row.value() == false){
+                break;
+            }
+            const std::span<const std::string_view> row = reader.cells();
+            for(size_t c = 0; c < indices.size(); ++c){
+                cells[c] = row[indices[c]];
+            }
+            writer.write_row(std::span<const std::string_view>(cells));
+        }
+        return {};
+    }
+
+}// namespace csvd
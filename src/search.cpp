@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include <csvd/search.hpp>
+
+namespace csvd{
+
+    namespace {
+
+        /**
+         * @brief Calls `function(comparison)` with `std::less` for ascending and `std::greater` for descending columns
+         */
+        template<class Function>
+        auto with_order(const Column& column, Function&& function){
+            switch(column.order()){
+                case Sortedness::Constant: case Sortedness::Ascending: return function(std::ranges::less{});
+                case Sortedness::Descending: return function(std::ranges::greater{});
+                case Sortedness::Unsorted: break;
+            }
+            throw std::invalid_argument("csvd: the column '" + column.name + "' is not sorted");
+        }
+
+        /**
+         * @brief Returns the first row of the sorted column for which `before(value)` is `false`
+         *
+         * `before` has to be `true` for a prefix of the column. The zones are bisected first, they are small and
+         * contiguous, so the scattered blocks of the deque are only probed within one zone.
+         */
+        template<class Before>
+        [[nodiscard]] size_t partition_point(const Column& column, Before&& before){
+            size_t first = 0;
+            size_t last = column.data.size();
+            if(column.has_zones()){
+                // a zone is completely before the partition point if its last value is, which is its min or its max
+                const auto zone = std::ranges::partition_point(column.zones, [&](const Zone& z){return before(z.min) && before(z.max);});
+                first = std::min(last, static_cast<size_t>(zone - column.zones.begin()) * zone_size);
+                last = std::min(last, first + zone_size);
+            }
+            const auto begin = column.data.begin();
+            const auto row = std::partition_point(begin + static_cast<std::ptrdiff_t>(first), begin + static_cast<std::ptrdiff_t>(last), before);
+            return static_cast<size_t>(row - begin);
+        }
+
+        template<class Comparison>
+        [[nodiscard]] size_t lower_bound(const Column& column, double value, Comparison comparison){
+            return partition_point(column, [&](double x){return comparison(x, value);});
+        }
+
+        template<class Comparison>
+        [[nodiscard]] size_t upper_bound(const Column& column, double value, Comparison comparison){
+            return partition_point(column, [&](double x){return comparison(value, x) == false;});
+        }
+
+    }// namespace
+
+    ColumnSlice slice(const Column& column, RowRange rows){
+        const size_t last = std::min(rows.last, column.data.size());
+        const size_t first = std::min(rows.first, last);
+        return ColumnSlice(column.data.begin() + static_cast<std::ptrdiff_t>(first), column.data.begin() + static_cast<std::ptrdiff_t>(last));
+    }
+
+    size_t lower_bound(const Column& column, double value){
+        return with_order(column, [&](auto comparison){
+            return lower_bound(column, value, comparison);
+        });
+    }
+
+    size_t upper_bound(const Column& column, double value){
+        return with_order(column, [&](auto comparison){
+            return upper_bound(column, value, comparison);
+        });
+    }
+
+    RowRange equal_range(const Column& column, double value){
+        return with_order(column, [&](auto comparison){
+            const size_t first = lower_bound(column, value, comparison);
+            return RowRange{first, std::max(first, upper_bound(column, value, comparison))};
+        });
+    }
+
+    RowRange find_range(const Column& column, double min, double max){
+        if((min <= max) == false){
+            return RowRange{};
+        }
+        return with_order(column, [&](auto comparison){
+            // in descending columns the larger bound comes first
+            const bool ascending = comparison(min, max);
+            const double front = ascending ? min : max;
+            const double back = ascending ? max : min;
+            const size_t first = lower_bound(column, front, comparison);
+            const size_t last = upper_bound(column, back, comparison);
+            return RowRange{first, std::max(first, last)};
+        });
+    }
+
+}// namespace csvd
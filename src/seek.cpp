@@ -0,0 +1,343 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <csvd/seek.hpp>
+#include <csvd/reader.hpp>
+
+namespace csvd{
+
+    namespace {
+
+        /// Number of bytes that are read at once while scanning for a line separator
+        constexpr size_t probe_size = 4096;
+
+        /**
+         * @brief A column that is selected by name or by index if the name is empty, like in `RowPredicate`
+         */
+        struct ColumnRef{
+            std::string_view name;
+            size_t index = 0;
+        };
+
+        [[nodiscard]] bool is_blank(std::string_view line){
+            return line.find_first_not_of(" \a\b\t\n\v\f\r") == std::string_view::npos;
+        }
+
+        /**
+         * @brief Random access to the lines of a CSV file
+         */
+        class LineFile{
+            public:
+
+                struct Line{
+                    std::string text;       ///< Without the line separator
+                    std::uint64_t next;     ///< The offset behind the line separator
+                };
+
+                LineFile(const std::filesystem::path& path, const Settings& settings)
+                    : stream_(path, std::ios::binary)
+                {
+                    for(const char c : settings.line_separators){
+                        if(c == '\0') break;
+                        this->is_line_separator_[static_cast<unsigned char>(c)] = true;
+                    }
+                    if(this->stream_.is_open()){
+                        this->stream_.seekg(0, std::ios::end);
+                        this->size_ = static_cast<std::uint64_t>(this->stream_.tellg());
+                    }
+                }
+
+                [[nodiscard]] inline bool good() const {return this->stream_.is_open() && !this->stream_.bad();}
+                [[nodiscard]] inline std::uint64_t size() const {return this->size_;}
+
+                /**
+                 * @brief Reads the line that starts at `start`
+                 */
+                [[nodiscard]] tl::expected<Line, ReadError> line_at(std::uint64_t start){
+                    Line line{std::string(), this->size_};
+                    for(std::uint64_t offset = start; offset < this->size_; offset += this->block_.size()){
+                        if(this->read(offset) == false){
+                            return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, 0, 0, '\0'));
+                        }
+                        const auto found = std::ranges::find_if(this->block_, [this](char c){return this->is_line_separator_[static_cast<unsigned char>(c)];});
+                        line.text.append(this->block_.begin(), found);
+                        if(found != this->block_.end()){
+                            line.next = offset + static_cast<std::uint64_t>(found - this->block_.begin()) + 1;
+                            break;
+                        }
+                    }
+                    return line;
+                }
+
+                /**
+                 * @brief Returns the start of the first non-blank line that starts at or after `position`, or the size of the file
+                 */
+                [[nodiscard]] tl::expected<std::uint64_t, ReadError> line_start(std::uint64_t position){
+                    // `position` starts a line if it follows a line separator, otherwise resync behind the next one
+                    std::uint64_t start = position;
+                    if(position > 0){
+                        tl::expected<Line, ReadError> partial = this->line_at(position - 1);
+                        if(partial.has_value() == false){
+                            return tl::unexpected(partial.error());
+                        }
+                        start = partial->next;
+                    }
+                    while(start < this->size_){
+                        tl::expected<Line, ReadError> line = this->line_at(start);
+                        if(line.has_value() == false){
+                            return tl::unexpected(line.error());
+                        }
+                        if(is_blank(line->text) == false){
+                            break;
+                        }
+                        start = line->next;
+                    }
+                    return std::min(start, this->size_);
+                }
+
+            private:
+
+                [[nodiscard]] bool read(std::uint64_t offset){
+                    this->block_.resize(static_cast<size_t>(std::min<std::uint64_t>(probe_size, this->size_ - offset)));
+                    this->stream_.clear();
+                    this->stream_.seekg(static_cast<std::streamoff>(offset));
+                    this->stream_.read(this->block_.data(), static_cast<std::streamsize>(this->block_.size()));
+                    return static_cast<size_t>(this->stream_.gcount()) == this->block_.size();
+                }
+
+                std::ifstream stream_;
+                std::uint64_t size_ = 0;
+                std::array<bool, 256> is_line_separator_{};
+                std::string block_;
+        };
+
+        /**
+         * @brief A file with a sorted key column
+         */
+        struct SortedFile{
+            LineFile file;
+            Settings settings;                  ///< The format of the file without row predicates
+            std::vector<std::string> names;     ///< The column names, empty if the file has no header
+            std::uint64_t data_begin = 0;       ///< The start of the first data row
+            size_t key = 0;                     ///< The index of the sorted column
+
+            SortedFile(const std::filesystem::path& path, const Settings& file_settings)
+                : file(path, file_settings)
+                , settings(file_settings)
+            {
+                this->settings.row_predicates.clear();
+            }
+
+            /**
+             * @brief Parses the cells of one line
+             *
+             * @param columns The columns to convert, all others are NaN
+             */
+            [[nodiscard]] tl::expected<std::vector<double>, ReadError> parse(const std::string& line, std::span<const size_t> columns) const {
+                Settings row_settings = this->settings;
+                row_settings.header_type = HeaderType::None;
+                std::istringstream stream(line);
+                Reader reader(stream, std::move(row_settings));
+                if(tl::expected<void, ReadError> header = reader.read_header(); header.has_value() == false){
+                    return tl::unexpected(header.error());
+                }
+                reader.select_columns(columns);
+                if(tl::expected<bool, ReadError> row = reader.next_row(); row.has_value() == false){
+                    return tl::unexpected(row.error());
+                }
+                return std::vector<double>(reader.values().begin(), reader.values().end());
+            }
+
+            /**
+             * @brief Reads the header and resolves the key column
+             */
+            [[nodiscard]] tl::expected<void, ReadError> open(ColumnRef column){
+                if(this->file.good() == false){
+                    return tl::unexpected(ReadError(ErrorCase::BadStream, "", {'\0'}, 0, 0, '\0'));
+                }
+                tl::expected<std::uint64_t, ReadError> first = this->file.line_start(0);
+                if(first.has_value() == false){
+                    return tl::unexpected(first.error());
+                }
+                this->data_begin = first.value();
+                if(this->data_begin < this->file.size()){
+                    tl::expected<LineFile::Line, ReadError> line = this->file.line_at(this->data_begin);
+                    if(line.has_value() == false){
+                        return tl::unexpected(line.error());
+                    }
+                    std::istringstream stream(line->text);
+                    Reader reader(stream, this->settings);
+                    if(tl::expected<void, ReadError> header = reader.read_header(); header.has_value() == false){
+                        return tl::unexpected(header.error());
+                    }
+                    // the first line is either a data row or the header
+                    tl::expected<bool, ReadError> is_data = reader.next_row();
+                    if(is_data.has_value() == false){
+                        return tl::unexpected(is_data.error());
+                    }
+                    if(is_data.value() == false){
+                        this->data_begin = line->next;
+                    }
+                    this->names = reader.names();
+                }
+
+                if(column.name.empty() == false){
+                    const auto found = std::ranges::find(this->names, column.name);
+                    if(found == this->names.end()){
+                        return tl::unexpected(ReadError(ErrorCase::UnknownColumn, column.name, {'\0'}, 0, 0, '\0'));
+                    }
+                    this->key = static_cast<size_t>(found - this->names.begin());
+                }else if(column.index >= this->names.size() && this->names.empty() == false){
+                    return tl::unexpected(ReadError(ErrorCase::UnknownColumn, std::to_string(column.index), {'\0'}, column.index, 0, '\0'));
+                }else{
+                    this->key = column.index;
+                }
+                return {};
+            }
+
+            /**
+             * @brief Bisects the byte offsets for the first row with a key `>= value`
+             */
+            [[nodiscard]] tl::expected<std::uint64_t, ReadError> seek(double value){
+                tl::expected<std::uint64_t, ReadError> lower = this->file.line_start(this->data_begin);
+                if(lower.has_value() == false){
+                    return lower;
+                }
+                // all rows before `first` have smaller keys, the row at `last` (if any) has not
+                std::uint64_t first = lower.value();
+                std::uint64_t last = this->file.size();
+                const std::array<size_t, 1> key_column{this->key};
+                while(first < last){
+                    tl::expected<std::uint64_t, ReadError> probe = this->file.line_start(first + (last - first) / 2);
+                    if(probe.has_value() == false){
+                        return probe;
+                    }
+                    // no line starts in the upper half, continue linearly from the front
+                    const std::uint64_t start = (probe.value() < last) ? probe.value() : first;
+
+                    tl::expected<LineFile::Line, ReadError> line = this->file.line_at(start);
+                    if(line.has_value() == false){
+                        return tl::unexpected(line.error());
+                    }
+                    tl::expected<std::vector<double>, ReadError> values = this->parse(line->text, key_column);
+                    if(values.has_value() == false){
+                        return tl::unexpected(values.error());
+                    }
+                    if(this->key >= values->size()){
+                        return tl::unexpected(ReadError(ErrorCase::UnknownColumn, std::to_string(this->key), {'\0'}, this->key, 0, '\0'));
+                    }
+
+                    if((*values)[this->key] < value){
+                        tl::expected<std::uint64_t, ReadError> next = this->file.line_start(line->next);
+                        if(next.has_value() == false){
+                            return next;
+                        }
+                        first = next.value();
+                    }else{
+                        last = start;
+                    }
+                }
+                return first;
+            }
+        };
+
+        tl::expected<std::uint64_t, ReadError> seek_value(const std::filesystem::path& path, ColumnRef column, double value, const Settings& settings){
+            SortedFile file(path, settings);
+            if(tl::expected<void, ReadError> opened = file.open(column); opened.has_value() == false){
+                return tl::unexpected(opened.error());
+            }
+            return file.seek(value);
+        }
+
+        tl::expected<CSVd, ReadError> read_range(const std::filesystem::path& path, ColumnRef column, double min, double max, const Settings& settings){
+            SortedFile file(path, settings);
+            if(tl::expected<void, ReadError> opened = file.open(column); opened.has_value() == false){
+                return tl::unexpected(opened.error());
+            }
+
+            CSVd result(settings);
+            for(const std::string& name : file.names){
+                Column result_column;
+                result_column.name = name;
+                if(settings.compute_statistics){
+                    result_column.statistics.emplace();
+                }
+                result.push_back(std::move(result_column));
+            }
+            if((min <= max) == false){
+                return result;
+            }
+
+            tl::expected<std::uint64_t, ReadError> offset = file.seek(min);
+            if(offset.has_value() == false){
+                return tl::unexpected(offset.error());
+            }
+            if(offset.value() >= file.file.size()){
+                return result;
+            }
+
+            // the rows are read without the header, so predicates on named columns are resolved to indices
+            Settings row_settings = settings;
+            row_settings.header_type = HeaderType::None;
+            for(RowPredicate& predicate : row_settings.row_predicates){
+                if(predicate.column.empty() == false){
+                    const auto found = std::ranges::find(file.names, predicate.column);
+                    if(found == file.names.end()){
+                        return tl::unexpected(ReadError(ErrorCase::UnknownColumn, predicate.column, {'\0'}, 0, 0, '\0'));
+                    }
+                    predicate.index = static_cast<size_t>(found - file.names.begin());
+                    predicate.column.clear();
+                }
+            }
+
+            std::ifstream stream(path, std::ios::binary);
+            stream.seekg(static_cast<std::streamoff>(offset.value()));
+            Reader reader(stream, std::move(row_settings));
+            if(tl::expected<void, ReadError> header = reader.read_header(); header.has_value() == false){
+                return tl::unexpected(header.error());
+            }
+            if(file.key >= reader.columns()){
+                return tl::unexpected(ReadError(ErrorCase::UnknownColumn, std::to_string(file.key), {'\0'}, file.key, 0, '\0'));
+            }
+            while(true){
+                tl::expected<bool, ReadError> row = reader.next_row();
+                if(row.has_value() == false){
+                    return tl::unexpected(row.error());
+                }
+                if(row.value() == false){
+                    break;
+                }
+                const std::span<const double> values = reader.values();
+                if(values[file.key] > max){
+                    break;
+                }
+                for(size_t c = 0; c < values.size() && c < result.size(); ++c){
+                    result[c].push_back(values[c]);
+                }
+            }
+            return result;
+        }
+
+    }// namespace
+
+    tl::expected<std::uint64_t, ReadError> seek_value(const std::filesystem::path& path, std::string_view column, double value, const Settings& settings){
+        return seek_value(path, ColumnRef{column, 0}, value, settings);
+    }
+
+    tl::expected<std::uint64_t, ReadError> seek_value(const std::filesystem::path& path, size_t column, double value, const Settings& settings){
+        return seek_value(path, ColumnRef{std::string_view(), column}, value, settings);
+    }
+
+    tl::expected<CSVd, ReadError> read_range(const std::filesystem::path& path, std::string_view column, double min, double max, const Settings& settings){
+        return read_range(path, ColumnRef{column, 0}, min, max, settings);
+    }
+
+    tl::expected<CSVd, ReadError> read_range(const std::filesystem::path& path, size_t column, double min, double max, const Settings& settings){
+        return read_range(path, ColumnRef{std::string_view(), column}, min, max, settings);
+    }
+
+}// namespace csvd
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <cstdint>
+
+#include <csvd/sort.hpp>
+
+#include "parallel.hpp"
+#include "columns.hpp"
+
+namespace csvd{
+
+    namespace {
+
+        /// Tables with fewer rows are sorted with a comparison sort
+        constexpr size_t radix_threshold = size_t(1) << 12;
+
+        struct Entry{
+            std::uint64_t key;
+            size_t row;
+        };
+
+        [[nodiscard]] inline std::uint64_t radix_key(double value, Order order){
+            const std::uint64_t key = detail::order_key(value);
+            return (order == Order::Ascending) ? key : ~key;
+        }
+
+        /**
+         * @brief Stable LSD radix sort with 8 bit digits. Digits that are equal for all entries are skipped.
+         */
+        void radix_sort(std::vector<Entry>& entries){
+            const size_t n = entries.size();
+            std::array<std::array<size_t, 256>, 8> histograms{};
+            for(const Entry& entry : entries){
+                for(size_t digit = 0; digit < 8; ++digit){
+                    ++histograms[digit][(entry.key >> (digit * 8)) & 0xFF];
+                }
+            }
+
+            std::vector<Entry> buffer(n);
+            for(size_t digit = 0; digit < 8; ++digit){
+                std::array<size_t, 256>& histogram = histograms[digit];
+                if(std::ranges::find(histogram, n) != histogram.end()){
+                    continue; // all entries have the same digit
+                }
+
+                size_t offset = 0;
+                for(size_t& count : histogram){
+                    const size_t c = count;
+                    count = offset;
+                    offset += c;
+                }
+
+                for(const Entry& entry : entries){
+                    buffer[histogram[(entry.key >> (digit * 8)) & 0xFF]++] = entry;
+                }
+                entries.swap(buffer);
+            }
+        }
+
+        /**
+         * @brief Stable sort of the permutation by one key column, in parallel for large inputs
+         */
+        void sort_by_key(std::vector<size_t>& permutation, const Column& column, Order order, const ParallelSettings& parallel){
+            const size_t n = permutation.size();
+            std::vector<Entry> entries(n);
+            const unsigned int threads = detail::thread_count(n, parallel);
+
+            // sort chunks independently
+            std::vector<size_t> bounds(threads + 1);
+            for(unsigned int part = 0; part <= threads; ++part){
+                bounds[part] = n * part / threads;
+            }
+            detail::parallel_for(n, threads, [&](unsigned int, size_t first, size_t last){
+                for(size_t i = first; i < last; ++i){
+                    entries[i] = Entry{radix_key(column.data[permutation[i]], order), permutation[i]};
+                }
+                std::vector<Entry> chunk(entries.begin() + first, entries.begin() + last);
+                radix_sort(chunk);
+                std::ranges::copy(chunk, entries.begin() + first);
+            });
+
+            // merge neighbouring chunks in parallel rounds, std::merge is stable
+            std::vector<Entry> buffer(n);
+            while(bounds.size() > 2){
+                const size_t merges = (bounds.size() - 1) / 2;
+                detail::parallel_for(merges, static_cast<unsigned int>(merges), [&](unsigned int, size_t first, size_t last){
+                    for(size_t m = first; m < last; ++m){
+                        const size_t a = bounds[2 * m];
+                        const size_t b = bounds[2 * m + 1];
+                        const size_t c = bounds[2 * m + 2];
+                        std::merge(entries.begin() + a, entries.begin() + b, entries.begin() + b, entries.begin() + c, buffer.begin() + a,
+                            [](const Entry& lhs, const Entry& rhs){return lhs.key < rhs.key;});
+                    }
+                });
+
+                // an odd chunk at the end is carried over unchanged
+                std::vector<size_t> merged;
+                for(size_t i = 0; i < bounds.size(); i += 2){
+                    merged.push_back(bounds[i]);
+                }
+                if(merged.back() != n){
+                    std::copy(entries.begin() + merged.back(), entries.end(), buffer.begin() + merged.back());
+                    merged.push_back(n);
+                }
+                bounds.swap(merged);
+                entries.swap(buffer);
+            }
+
+            for(size_t i = 0; i < n; ++i){
+                permutation[i] = entries[i].row;
+            }
+        }
+
+    }// namespace
+
+    std::vector<size_t> sort_permutation(const CSVd& table, const std::vector<std::string_view>& columns, const std::vector<Order>& orders, const ParallelSettings& parallel){
+        std::vector<const Column*> keys;
+        for(const std::string_view name : columns){
+            keys.push_back(&detail::column_by_name(table, name));
+        }
+        const auto order_of = [&](size_t k){return (k < orders.size()) ? orders[k] : Order::Ascending;};
+
+        const size_t n = detail::row_count(table);
+        std::vector<size_t> permutation(n);
+        std::iota(permutation.begin(), permutation.end(), size_t(0));
+
+        if(n < radix_threshold){
+            std::ranges::stable_sort(permutation, [&](size_t lhs, size_t rhs){
+                for(size_t k = 0; k < keys.size(); ++k){
+                    const std::uint64_t a = radix_key(keys[k]->data[lhs], order_of(k));
+                    const std::uint64_t b = radix_key(keys[k]->data[rhs], order_of(k));
+                    if(a != b){
+                        return a < b;
+                    }
+                }
+                return false;
+            });
+            return permutation;
+        }
+
+        // least significant key first, every pass is stable
+        for(size_t k = keys.size(); k-- > 0;){
+            sort_by_key(permutation, *keys[k], order_of(k), parallel);
+        }
+        return permutation;
+    }
+
+    void apply_permutation(CSVd& table, const std::vector<size_t>& permutation, const ParallelSettings& parallel){
+        const size_t n = permutation.size();
+        const unsigned int threads = std::min<unsigned int>(
+            detail::thread_count(n * table.size(), parallel),
+            static_cast<unsigned int>(std::max<size_t>(table.size(), 1)));
+
+        detail::parallel_for(table.size(), threads, [&](unsigned int, size_t first, size_t last){
+            // random reads go into a contiguous copy instead of the deque
+            std::vector<double> source;
+            for(size_t c = first; c < last; ++c){
+                std::deque<double>& data = table[c].values();
+                if(data.size() < n){
+                    continue;
+                }
+                source.assign(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(n));
+                for(size_t i = 0; i < n; ++i){
+                    data[i] = source[permutation[i]];
+                }
+                table[c].update_sortedness();
+                table[c].update_zones();
+            }
+        });
+    }
+
+    void sort_by(CSVd& table, const std::vector<std::string_view>& columns, const std::vector<Order>& orders, const ParallelSettings& parallel){
+        const std::vector<size_t> permutation = sort_permutation(table, columns, orders, parallel);
+        apply_permutation(table, permutation, parallel);
+    }
+
+}// namespace csvd
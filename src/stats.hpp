@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+
+#include <csvd/csvd.hpp>
+
+/**
+ * @brief Enables the instrumentation of `ReadStats`
+ *
+ * Without it every counter and clock read is discarded at compile time.
+ */
+#ifndef CSVD_ENABLE_STATS
+    #define CSVD_ENABLE_STATS 0
+#endif
+
+namespace csvd::detail{
+
+    inline constexpr bool stats_enabled = (CSVD_ENABLE_STATS != 0);
+
+    /**
+     * @brief Returns the current time, or a constant if the statistics are disabled
+     */
+    [[nodiscard]] inline std::chrono::steady_clock::time_point stats_now(){
+        if constexpr (stats_enabled){
+            return std::chrono::steady_clock::now();
+        }else{
+            return std::chrono::steady_clock::time_point();
+        }
+    }
+
+}// namespace csvd::detail
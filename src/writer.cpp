@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <locale>
+
+#include <csvd/writer.hpp>
+
+namespace csvd{
+
+    namespace {
+
+        /// The buffer is written to the stream once it grows beyond this size
+        constexpr size_t flush_size = size_t(1) << 16;
+
+    }// namespace
+
+    Writer::Writer(std::ostream& stream, Settings settings)
+        : stream_(stream)
+        , settings_(std::move(settings))
+    {
+        const std::ios_base::fmtflags flags = stream.flags();
+        const std::ios_base::fmtflags floatfield = flags & std::ios_base::floatfield;
+        if(floatfield == std::ios_base::fixed){
+            this->format_ = std::chars_format::fixed;
+        }else if(floatfield == std::ios_base::scientific){
+            this->format_ = std::chars_format::scientific;
+        }else if(floatfield == (std::ios_base::fixed | std::ios_base::scientific)){
+            this->format_ = std::chars_format::hex;
+            this->use_precision_ = false;
+        }
+        this->precision_ = static_cast<int>(stream.precision());
+
+        // flags that change the appearance of numbers beyond what `to_chars` can do
+        const std::ios_base::fmtflags unsupported = std::ios_base::showpos | std::ios_base::showpoint | std::ios_base::uppercase;
+        this->through_stream_ = (flags & unsupported) || stream.width() != 0 || stream.getloc() != std::locale::classic();
+
+        for(const auto& separators : {this->settings_.value_separators, this->settings_.line_separators}){
+            for(const char c : separators){
+                if(c == '\0') break;
+                this->is_separator_[static_cast<unsigned char>(c)] = true;
+            }
+        }
+    }
+
+    Writer::~Writer(){
+        this->flush();
+    }
+
+    void Writer::flush(){
+        if(this->buffer_.empty() == false){
+            this->stream_.write(this->buffer_.data(), static_cast<std::streamsize>(this->buffer_.size()));
+            this->buffer_.clear();
+        }
+    }
+
+    void Writer::append(std::string_view text){
+        if(this->through_stream_){
+            this->stream_ << text;
+        }else{
+            this->buffer_.append(text);
+        }
+    }
+
+    void Writer::append(char character){
+        if(this->through_stream_){
+            this->stream_ << character;
+        }else{
+            this->buffer_.push_back(character);
+        }
+    }
+
+    void Writer::append(double value){
+        if(this->through_stream_){
+            this->stream_ << value;
+            return;
+        }
+        // enough for `%f` of the largest double with a precision of up to 400 digits
+        std::array<char, 768> characters;
+        const std::to_chars_result result = this->use_precision_
+            ? std::to_chars(characters.data(), characters.data() + characters.size(), value, this->format_, this->precision_)
+            : std::to_chars(characters.data(), characters.data() + characters.size(), value, this->format_);
+        if(result.ec != std::errc()){
+            this->flush();
+            this->stream_ << value;
+            return;
+        }
+        const char* first = characters.data();
+        const char* const last = result.ptr;
+        if(this->format_ == std::chars_format::hex && std::isfinite(value)){
+            // `to_chars` omits the prefix of hexfloats that the stream writes behind the sign
+            if(*first == '-'){
+                this->buffer_.push_back(*first++);
+            }
+            this->buffer_.append("0x");
+        }
+        this->buffer_.append(first, last);
+    }
+
+    void Writer::write_header(const std::vector<std::string>& names){
+        if(names.empty()){
+            return;
+        }
+
+        HeaderType header_type = this->settings_.header_type;
+        if(header_type == HeaderType::Auto){
+            header_type = HeaderType::None;
+            for(const std::string& name : names){
+                if(name.empty() == false){
+                    header_type = HeaderType::FirstRow;
+                    break;
+                }
+            }
+        }
+        if(header_type != HeaderType::FirstRow){
+            return;
+        }
+
+        const char quote = this->settings_.quotes[0]; // quotes is guaranteed to not be empty
+        for(size_t index = 0; index < names.size(); ++index){
+            if(this->settings_.auto_quotes){
+                this->append(quote);
+            }
+
+            if(names[index].empty() == false){
+                this->append(names[index]);
+            }else{
+                // print column number in quotes
+                if(this->settings_.auto_quotes == false){
+                    this->append(quote);
+                }
+                this->append(std::string_view(std::to_string(index)));
+                if(this->settings_.auto_quotes == false){
+                    this->append(quote);
+                }
+            }
+
+            if(this->settings_.auto_quotes){
+                this->append(quote);
+            }
+
+            if(index + 1 == names.size()){
+                this->append(this->settings_.line_separators[0]); // line separator is guaranteed to not be empty
+            }else{
+                this->append(this->settings_.value_separators[0]); // value_separators is guaranteed to not be empty
+            }
+        }
+    }
+
+    void Writer::end_cell(bool is_last){
+        if(is_last){
+            this->append(this->settings_.line_separators[0]); // line separator is guaranteed to not be empty
+        }else{
+            this->append(this->settings_.value_separators[0]); // value_separators is guaranteed to not be empty
+        }
+    }
+
+    void Writer::write_row(std::span<const double> values){
+        for(size_t index = 0; index < values.size(); ++index){
+            this->append(values[index]);
+            this->end_cell(index + 1 == values.size());
+        }
+        if(this->buffer_.size() >= flush_size){
+            this->flush();
+        }
+    }
+
+    void Writer::write_row(std::span<const std::string_view> cells){
+        const std::string_view quotes(this->settings_.quotes.data(), std::ranges::find(this->settings_.quotes, '\0'));
+        const char quote = this->settings_.quotes[0]; // quotes is guaranteed to not be empty
+        for(size_t index = 0; index < cells.size(); ++index){
+            const std::string_view cell = cells[index];
+            const bool is_quoted = (cell.empty() == false) && (quotes.find(cell.front()) != std::string_view::npos);
+            const bool needs_quotes = (is_quoted == false) && std::ranges::any_of(cell, [this](char c){
+                return this->is_separator_[static_cast<unsigned char>(c)];
+            });
+            if(needs_quotes){
+                this->append(quote);
+                this->append(cell);
+                this->append(quote);
+            }else{
+                this->append(cell);
+            }
+            this->end_cell(index + 1 == cells.size());
+        }
+        if(this->buffer_.size() >= flush_size){
+            this->flush();
+        }
+    }
+
+}// namespace csvd
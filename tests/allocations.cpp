@@ -0,0 +1,149 @@
+/**
+ * Allocation budgets of the hot paths
+ *
+ * This test runs as its own executable because it replaces the global `operator new` and `operator delete`
+ * to count every allocation. Parsing and writing must not allocate per row: the budgets only allow
+ * allocations that grow with the stored data (the blocks of the column deques) or a constant number.
+ */
+
+#include <csvd/csvd.hpp>
+#include <csvd/reader.hpp>
+#include <csvd/writer.hpp>
+#include <csvd/query.hpp>
+#include <csvd/rewrite.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+#include "fixtures.hpp"
+
+namespace {
+
+    std::atomic<bool> counting{false};
+    std::atomic<size_t> allocations{0};
+
+    /**
+     * @brief Returns the number of allocations that `function` makes
+     */
+    template<class Function>
+    size_t count_allocations(Function&& function){
+        allocations = 0;
+        counting = true;
+        function();
+        counting = false;
+        return allocations;
+    }
+
+    /**
+     * @brief A stream buffer that discards everything, so the output does not allocate
+     */
+    class NullBuffer : public std::streambuf{
+        protected:
+            std::streamsize xsputn(const char*, std::streamsize count) override {return count;}
+            int_type overflow(int_type c) override {return traits_type::not_eof(c);}
+    };
+
+    std::string make_file(size_t rows, size_t columns){
+        std::string header;
+        for(size_t c = 0; c < columns; ++c){
+            header += ((c == 0) ? "Column " : ", Column ") + std::to_string(c);
+        }
+        return ::make_file(header, rows, [&](std::ostream& file, size_t r){
+            for(size_t c = 0; c < columns; ++c){
+                file << ((c == 0) ? "" : ", ") << (r * columns + c) << ".125";
+            }
+        });
+    }
+
+}// namespace
+
+void* operator new(std::size_t size){
+    if(counting.load(std::memory_order_relaxed)){
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if(void* pointer = std::malloc((size != 0) ? size : 1)){
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {std::free(pointer);}
+void operator delete(void* pointer, std::size_t) noexcept {std::free(pointer);}
+
+static constexpr size_t columns = 4;
+
+TEST(allocations, read){
+    // the only allocations that grow with the file are the blocks of the column storage
+    const std::string small_file = make_file(10'000, columns);
+    const std::string large_file = make_file(20'000, columns);
+    const auto read = [](const std::string& text){
+        return count_allocations([&]{
+            std::istringstream stream(text);
+            csvd::CSVd csv;
+            ASSERT_TRUE(csv.read(stream).has_value());
+        });
+    };
+    const size_t small = read(small_file);
+    const size_t large = read(large_file);
+    const size_t values = 10'000 * columns;
+    ASSERT_LE(large - small, values / 32 + 16) << small << " allocations for 10000 rows, " << large << " for 20000 rows";
+}
+
+TEST(allocations, write){
+    std::istringstream stream(make_file(20'000, columns));
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(stream);
+    ASSERT_TRUE(csv.has_value());
+
+    NullBuffer buffer;
+    std::ostream output(&buffer);
+    const size_t count = count_allocations([&]{csv->write(output);});
+    ASSERT_LE(count, 32);
+}
+
+TEST(allocations, streaming){
+    const std::string file = make_file(20'000, columns);
+
+    // after the first rows the reader and the writer reuse their buffers
+    NullBuffer buffer;
+    std::ostream output(&buffer);
+    std::istringstream stream(file);
+    csvd::Reader reader(stream);
+    csvd::Writer writer(output);
+    ASSERT_TRUE(reader.read_header().has_value());
+    for(size_t row = 0; row < 100; ++row){
+        ASSERT_TRUE(reader.next_row().value());
+        writer.write_row(reader.values());
+    }
+    const size_t rows = count_allocations([&]{
+        while(reader.next_row().value()){
+            writer.write_row(reader.values());
+        }
+    });
+    ASSERT_LE(rows, 16);
+
+    // the pipelines only allocate a constant amount
+    const size_t query = count_allocations([&]{
+        std::istringstream input(file);
+        ASSERT_TRUE(csvd::Query(input).filter(csvd::col("Column 1") > 100.0).derive("Sum", csvd::col("Column 0") + csvd::col("Column 2")).write(output).has_value());
+    });
+    ASSERT_LE(query, 256);
+
+    const size_t found = count_allocations([&]{
+        std::istringstream input(file);
+        ASSERT_TRUE(csvd::find_first_row(input, csvd::col("Column 0") < 0.0).has_value());
+    });
+    ASSERT_LE(found, 128);
+
+    const size_t rewritten = count_allocations([&]{
+        std::istringstream input(file);
+        ASSERT_TRUE(csvd::rewrite(input, output, {"Column 2", "Column 0"}).has_value());
+    });
+    ASSERT_LE(rewritten, 128);
+}
@@ -0,0 +1,71 @@
+#include <csvd/compute.hpp>
+
+#include <cmath>
+
+// google test
+#include <gtest/gtest.h>
+
+#include "fixtures.hpp"
+
+static double wave(size_t i){
+    return std::sin(static_cast<double>(i)) * static_cast<double>(i % 97);
+}
+
+static const csvd::ParallelSettings parallel{.threshold = 1000, .max_threads = 4};
+
+TEST(compute, sum_and_mean){
+    const csvd::Column column = make_column("", 10'007, wave);
+    long double expected = 0;
+    for(double value : column.data) expected += value;
+
+    ASSERT_NEAR(csvd::sum(column), static_cast<double>(expected), 1e-9);
+    ASSERT_NEAR(csvd::sum(column, parallel), static_cast<double>(expected), 1e-9);
+    ASSERT_NEAR(csvd::mean(column, parallel), static_cast<double>(expected) / column.data.size(), 1e-12);
+
+    // compensated summation does not loose the small values
+    csvd::Column precise;
+    precise.push_back(1e16);
+    for(int i = 0; i < 1000; ++i) precise.push_back(1.0);
+    precise.push_back(-1e16);
+    ASSERT_DOUBLE_EQ(csvd::sum(precise), 1000.0);
+
+    ASSERT_EQ(csvd::sum(csvd::Column()), 0.0);
+    ASSERT_TRUE(std::isnan(csvd::mean(csvd::Column())));
+}
+
+TEST(compute, minimum_and_maximum){
+    csvd::Column column = make_column("", 5'000, wave);
+    column.values()[3'333] = -1000;
+    column.values()[4'444] = 1000;
+    column.values()[4'445] = 1000;
+    column.values()[10] = std::nan("");
+
+    const csvd::Extremum min = csvd::minimum(column, parallel);
+    ASSERT_EQ(min.value, -1000);
+    ASSERT_EQ(min.index, 3'333);
+
+    const csvd::Extremum max = csvd::maximum(column, parallel);
+    ASSERT_EQ(max.value, 1000);
+    ASSERT_EQ(max.index, 4'444); // first occurrence
+
+    ASSERT_EQ(csvd::minimum(csvd::Column()).index, std::numeric_limits<size_t>::max());
+}
+
+TEST(compute, dot_norm_variance){
+    const csvd::Column a = make_column("", 3'000, wave);
+    const csvd::Column b = make_column("", 2'000, wave);
+
+    double expected_dot = 0;
+    for(size_t i = 0; i < b.data.size(); ++i) expected_dot += a.data[i] * b.data[i];
+    ASSERT_NEAR(csvd::dot(a, b, parallel), expected_dot, 1e-6);
+    ASSERT_NEAR(csvd::norm(b, parallel), std::sqrt(expected_dot), 1e-9);
+
+    csvd::Column reference = a;
+    reference.enable_statistics();
+    const csvd::Statistics stats = csvd::statistics(a, parallel);
+    ASSERT_EQ(stats.count, reference.statistics->count);
+    ASSERT_EQ(stats.min, reference.statistics->min);
+    ASSERT_EQ(stats.max, reference.statistics->max);
+    ASSERT_NEAR(stats.mean, reference.statistics->mean, 1e-12);
+    ASSERT_NEAR(csvd::variance(a, parallel), reference.statistics->variance(), 1e-9);
+}
@@ -0,0 +1,62 @@
+#include <csvd/diagnostics.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+#include "fixtures.hpp"
+
+static std::string make_file(size_t rows, size_t bad_row){
+    return make_file("Time, Voltage, Current", rows, [&](std::ostream& file, size_t i){
+        file << i << ", 1.5, " << ((i == bad_row) ? "x2" : "2.5");
+    });
+}
+
+TEST(diagnostics, error_context_buffer){
+    const std::string text = make_file(20'000, 15'000);
+    std::istringstream stream(text);
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(stream);
+    ASSERT_FALSE(csv.has_value());
+    const csvd::ReadError& error = csv.error();
+    ASSERT_EQ(error.line_offset(), text.find("15000, "));
+    ASSERT_EQ(error.offset(), text.find("x2"));
+
+    const csvd::ErrorContext context = csvd::error_context(text, error);
+    ASSERT_EQ(context.line, "15000, 1.5, x2");
+    ASSERT_EQ(context.line_offset, error.line_offset());
+    ASSERT_EQ(context.position, 12);
+
+    std::ostringstream printed;
+    printed << context;
+    ASSERT_EQ(printed.str(), "15000, 1.5, x2\n            ^");
+
+    // offsets are absolute if the read starts in the middle of a seekable stream
+    const std::string prefix = "# generated\n";
+    std::istringstream shifted(prefix + text);
+    shifted.seekg(static_cast<std::streamoff>(prefix.size()));
+    tl::expected<csvd::CSVd, csvd::ReadError> shifted_csv = csvd::read(shifted);
+    ASSERT_FALSE(shifted_csv.has_value());
+    ASSERT_EQ(shifted_csv.error().offset(), prefix.size() + error.offset());
+}
+
+TEST(diagnostics, read_error_context){
+    const std::string text = make_file(50'000, 49'999);
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "csvd_diagnostics.csv";
+    std::ofstream(path, std::ios::binary) << text;
+
+    std::ifstream file(path, std::ios::binary);
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(file);
+    ASSERT_FALSE(csv.has_value());
+
+    tl::expected<csvd::ErrorContext, csvd::ReadError> context = csvd::read_error_context(path, csv.error());
+    ASSERT_TRUE(context.has_value()) << context.error();
+    ASSERT_EQ(context->line, "49999, 1.5, x2");
+    ASSERT_EQ(context->position, 12);
+
+    ASSERT_FALSE(csvd::read_error_context(std::filesystem::temp_directory_path() / "csvd_missing.csv", csv.error()).has_value());
+    std::filesystem::remove(path);
+}
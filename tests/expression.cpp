@@ -0,0 +1,72 @@
+#include <csvd/expression.hpp>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+using csvd::col;
+
+TEST(expression, evaluate){
+    csvd::CSVd csv;
+    csv.push_back(csvd::Column());
+    csv.push_back(csvd::Column());
+    csv[0].name = "Real";
+    csv[1].name = "Imag";
+    const size_t rows = 5000;
+    for(size_t i = 0; i < rows; ++i){
+        csv[0].push_back(std::cos(static_cast<double>(i)) * 3.0);
+        csv[1].push_back(std::sin(static_cast<double>(i)) * 3.0);
+    }
+
+    csvd::ParallelSettings parallel;
+    parallel.threshold = 1000;
+    parallel.max_threads = 3;
+    const csvd::Column magnitude = csvd::evaluate(csv, csvd::hypot(col("Real"), col("Imag")), "Magnitude", parallel);
+    const csvd::Column phase = csvd::evaluate(csv, csvd::atan2(col("Imag"), col("Real")) * (180.0 / M_PI));
+    const csvd::Column mixed = csvd::evaluate(csv, csvd::where(col("Real") > 0.0 && !(col("Imag") < 0.0), -col("Real") * 2.0 + 1.0, csvd::sqrt(csvd::abs(col("Imag")))));
+
+    ASSERT_EQ(magnitude.name, "Magnitude");
+    ASSERT_EQ(magnitude.data.size(), rows);
+    ASSERT_EQ(phase.data.size(), rows);
+    for(size_t i = 0; i < rows; ++i){
+        const double re = csv[0].data[i];
+        const double im = csv[1].data[i];
+        ASSERT_DOUBLE_EQ(magnitude.data[i], std::hypot(re, im));
+        ASSERT_DOUBLE_EQ(phase.data[i], std::atan2(im, re) * (180.0 / M_PI));
+        ASSERT_DOUBLE_EQ(mixed.data[i], (re > 0.0 && !(im < 0.0)) ? (-re * 2.0 + 1.0) : std::sqrt(std::abs(im)));
+    }
+
+    // constants only and unknown columns
+    const csvd::Column constant = csvd::evaluate(csv, csvd::Expr(2.0) + 3.0);
+    ASSERT_EQ(constant.data.size(), rows);
+    ASSERT_EQ(constant.data[0], 5.0);
+    ASSERT_THROW((void)csvd::evaluate(csv, col("Missing") * 2.0), std::out_of_range);
+
+    const std::vector<std::string> columns = (col("Imag") + col("Real") * col("Imag")).columns();
+    ASSERT_EQ(columns, (std::vector<std::string>{"Imag", "Real"}));
+}
+
+TEST(expression, write){
+    csvd::CSVd csv;
+    csv.push_back(csvd::Column());
+    csv.push_back(csvd::Column());
+    csv[0].name = "Voltage";
+    csv[1].name = "Current";
+    for(const double value : {1.0, 2.0, 3.0}) csv[0].push_back(value);
+    for(const double value : {0.5, 0.25, 2.0}) csv[1].push_back(value);
+
+    std::stringstream out;
+    csvd::write(out, csv, {
+        {"Voltage", col("Voltage")},
+        {"Power", col("Voltage") * col("Current")},
+        {"High", col("Current") >= 1.0},
+    });
+    ASSERT_EQ(out.str(),
+        "\"Voltage\",\"Power\",\"High\"\n"
+        "1,0.5,0\n"
+        "2,0.5,0\n"
+        "3,6,1\n");
+}
@@ -0,0 +1,109 @@
+#include <csvd/filter.hpp>
+
+#include <cmath>
+
+// google test
+#include <gtest/gtest.h>
+
+#include "fixtures.hpp"
+
+static csvd::CSVd make_table(size_t rows){
+    csvd::CSVd table;
+    table.push_back(make_column("Time", rows, [](size_t i){return static_cast<double>(i);}));
+    table.push_back(make_column("Value", rows, [](size_t i){return std::sin(static_cast<double>(i));}));
+    return table;
+}
+
+static const csvd::ParallelSettings parallel{.threshold = 500, .max_threads = 4};
+
+TEST(filter, compare_and_combine){
+    const csvd::CSVd table = make_table(3'001);
+    const csvd::Column& time = table[0];
+    const csvd::Column& value = table[1];
+
+    const csvd::Selection positive = csvd::compare(value, csvd::Comparison::Greater, 0.0, parallel);
+    const csvd::Selection window = csvd::between(time, 100, 1999, parallel);
+    const csvd::Selection both = positive & window;
+    const csvd::Selection either = positive | ~window;
+
+    ASSERT_EQ(both.size(), 3'001);
+    size_t expected_both = 0;
+    for(size_t i = 0; i < 3'001; ++i){
+        const bool is_positive = value.data[i] > 0.0;
+        const bool is_in_window = (100 <= i) && (i <= 1999);
+        ASSERT_EQ(positive[i], is_positive);
+        ASSERT_EQ(window[i], is_in_window);
+        ASSERT_EQ(both[i], is_positive && is_in_window);
+        ASSERT_EQ(either[i], is_positive || !is_in_window);
+        expected_both += (is_positive && is_in_window) ? 1 : 0;
+    }
+    ASSERT_EQ(both.count(), expected_both);
+    ASSERT_EQ((~csvd::Selection(70)).count(), 70);
+
+    const csvd::Selection column_compare = csvd::compare(time, csvd::Comparison::LessEqual, value, parallel);
+    ASSERT_EQ(column_compare.count(), 1); // only i = 0 satisfies i <= sin(i)
+    ASSERT_TRUE(column_compare[0]);
+}
+
+TEST(filter, filter_table){
+    csvd::CSVd table = make_table(2'000);
+    table[1].enable_statistics();
+
+    const csvd::Selection selection = csvd::between(table[0], 10, 19) | csvd::compare(table[0], csvd::Comparison::Equal, 1500);
+    const csvd::CSVd filtered = csvd::filter(table, selection, parallel);
+
+    ASSERT_EQ(filtered.size(), 2);
+    ASSERT_EQ(filtered[0].name, "Time");
+    ASSERT_EQ(filtered[0].data.size(), 11);
+    ASSERT_EQ(filtered[0].data.front(), 10);
+    ASSERT_EQ(filtered[0].data.back(), 1500);
+    ASSERT_DOUBLE_EQ(filtered[1].data.back(), std::sin(1500.0));
+    ASSERT_TRUE(filtered[1].statistics.has_value());
+    ASSERT_EQ(filtered[1].statistics->count, 11);
+
+    const std::vector<size_t> rows{5, 3, 1};
+    const csvd::CSVd taken = csvd::take(table, rows);
+    ASSERT_EQ(taken[0].data.size(), 3);
+    ASSERT_EQ(taken[0].data[0], 5);
+    ASSERT_EQ(taken[0].data[2], 1);
+}
+
+TEST(filter, zone_maps){
+    // slowly drifting values with a few NaNs, like a sensor log
+    csvd::Column column;
+    for(size_t i = 0; i < 20'000; ++i){
+        column.push_back((i % 7'777 == 100) ? NAN : static_cast<double>(i / 5'000) + std::sin(static_cast<double>(i)) * 0.25);
+    }
+    ASSERT_EQ(column.zones.size(), 5);
+    ASSERT_TRUE(column.has_zones());
+    ASSERT_TRUE(column.zones[0].has_nan);
+    ASSERT_FALSE(column.zones[4].has_nan);
+    ASSERT_LE(column.zones[4].max, 3.25);
+    ASSERT_GE(column.zones[4].min, 2.75);
+
+    using enum csvd::Comparison;
+    for(const csvd::Comparison comparison : {Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual}){
+        for(const double x : {-1.0, 0.0, 1.5, 3.0, 10.0, column.data[42], double(NAN)}){
+            const csvd::Selection selection = csvd::compare(column, comparison, x, parallel);
+            for(size_t i = 0; i < column.data.size(); ++i){
+                const double v = column.data[i];
+                const bool expected = (comparison == Less) ? v < x : (comparison == LessEqual) ? v <= x : (comparison == Greater) ? v > x
+                                    : (comparison == GreaterEqual) ? v >= x : (comparison == Equal) ? v == x : v != x;
+                ASSERT_EQ(selection[i], expected) << "row " << i << ", x = " << x;
+            }
+        }
+    }
+    const csvd::Selection window = csvd::between(column, 0.9, 2.1, parallel);
+    for(size_t i = 0; i < column.data.size(); ++i){
+        ASSERT_EQ(window[i], column.data[i] >= 0.9 && column.data[i] <= 2.1);
+    }
+
+    // in place modifications are not hidden by the outdated zones
+    column.values()[19'999] = 100;
+    ASSERT_FALSE(column.has_zones());
+    ASSERT_EQ(csvd::compare(column, Greater, 50, parallel).count(), 1);
+    ASSERT_EQ(csvd::between(column, 50, 150, parallel).count(), 1);
+    column.update_zones();
+    ASSERT_EQ(column.zones[4].max, 100);
+    ASSERT_EQ(csvd::compare(column, Greater, 50, parallel).count(), 1);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * Fixtures that are shared by the tests
+ */
+
+#include <csvd/csvd.hpp>
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Returns a column with the values, appended so the running information of the column is maintained
+ */
+inline csvd::Column make_column(std::string name, const std::vector<double>& values){
+    csvd::Column column;
+    column.name = std::move(name);
+    column.append(values.begin(), values.end());
+    return column;
+}
+
+/**
+ * @brief Returns a column with the `rows` values `value(i)`
+ */
+template<class Function>
+csvd::Column make_column(std::string name, size_t rows, Function&& value){
+    csvd::Column column;
+    column.name = std::move(name);
+    for(size_t i = 0; i < rows; ++i){
+        column.push_back(value(i));
+    }
+    return column;
+}
+
+/**
+ * @brief Returns a CSV text with the header line and `rows` data lines that are written by `write_row(stream, i)`
+ */
+template<class Function>
+std::string make_file(std::string_view header, size_t rows, Function&& write_row){
+    std::ostringstream file;
+    file << header << '\n';
+    for(size_t i = 0; i < rows; ++i){
+        write_row(file, i);
+        file << '\n';
+    }
+    return file.str();
+}
@@ -0,0 +1,103 @@
+#include <csvd/group.hpp>
+#include <csvd/sort.hpp>
+
+#include <cmath>
+#include <random>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+#include "fixtures.hpp"
+
+TEST(group, aggregate){
+    csvd::CSVd csv;
+    csv.push_back(make_column("Channel", {2, 1, 2, 3, 1, 2}));
+    csv.push_back(make_column("Voltage", {4.0, 1.0, 6.0, NAN, 3.0, 5.0}));
+
+    const csvd::CSVd report = csvd::group_by(csv, {"Channel"}).aggregate({
+        {"Voltage", csvd::Aggregate::Sum},
+        {"Voltage", csvd::Aggregate::Mean},
+        {"Voltage", csvd::Aggregate::Min},
+        {"Voltage", csvd::Aggregate::Max},
+        {"Voltage", csvd::Aggregate::Count},
+    });
+
+    ASSERT_EQ(report.size(), 6);
+    ASSERT_EQ(report[0].name, "Channel");
+    ASSERT_EQ(report[1].name, "Voltage_sum");
+    ASSERT_EQ(report[5].name, "Voltage_count");
+
+    // sorted by key, NaN values are ignored
+    const std::vector<std::vector<double>> expected{
+        {1, 2, 3},
+        {4, 15, 0},
+        {2, 5, NAN},
+        {1, 4, NAN},
+        {3, 6, NAN},
+        {2, 3, 0},
+    };
+    for(size_t c = 0; c < expected.size(); ++c){
+        ASSERT_EQ(report[c].data.size(), 3);
+        for(size_t row = 0; row < 3; ++row){
+            if(std::isnan(expected[c][row])){
+                ASSERT_TRUE(std::isnan(report[c].data[row]));
+            }else{
+                ASSERT_DOUBLE_EQ(report[c].data[row], expected[c][row]) << report[c].name << " row " << row;
+            }
+        }
+    }
+
+    ASSERT_THROW((void)csvd::group_by(csv, {"Missing"}).aggregate({}), std::out_of_range);
+}
+
+TEST(group, sorted_and_hashed_paths_agree){
+    // many rows on multiple threads, two keys with a NaN group
+    std::mt19937_64 generator(7);
+    std::uniform_int_distribution<int> key(0, 40);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+
+    csvd::CSVd shuffled;
+    shuffled.push_back(csvd::Column());
+    shuffled.push_back(csvd::Column());
+    shuffled.push_back(csvd::Column());
+    shuffled[0].name = "A";
+    shuffled[1].name = "B";
+    shuffled[2].name = "Value";
+    for(size_t row = 0; row < 50000; ++row){
+        const int a = key(generator);
+        shuffled[0].push_back((a == 40) ? NAN : (a % 7 == 0 ? -0.0 : a % 7));
+        shuffled[1].push_back(a % 3);
+        shuffled[2].push_back(value(generator));
+    }
+
+    csvd::ParallelSettings parallel;
+    parallel.threshold = 1000;
+    parallel.max_threads = 4;
+    const std::vector<csvd::Aggregation> aggregations{
+        {"Value", csvd::Aggregate::Sum},
+        {"Value", csvd::Aggregate::Max},
+        {"Value", csvd::Aggregate::Count},
+    };
+    const csvd::CSVd hashed = csvd::group_by(shuffled, {"A", "B"}, parallel).aggregate(aggregations);
+
+    // the same aggregation on the sorted table takes the sort based path, runs of equal keys span threads
+    csvd::CSVd presorted = shuffled;
+    csvd::sort_by(presorted, {"A", "B"});
+    const csvd::CSVd sorted = csvd::group_by(presorted, {"A", "B"}, parallel).aggregate(aggregations);
+    const csvd::CSVd single = csvd::group_by(shuffled, {"A", "B"}, csvd::ParallelSettings{.threshold = 0, .max_threads = 1}).aggregate(aggregations);
+
+    ASSERT_EQ(hashed[0].data.size(), 7 * 3 + 1);
+    ASSERT_TRUE(std::isnan(hashed[0].data.back()));
+    ASSERT_EQ(sorted[0].data.size(), hashed[0].data.size());
+    double count = 0;
+    for(size_t row = 0; row < hashed[0].data.size(); ++row){
+        ASSERT_EQ(sorted[1].data[row], hashed[1].data[row]);
+        ASSERT_NEAR(sorted[2].data[row], hashed[2].data[row], 1e-9);
+        ASSERT_EQ(sorted[4].data[row], hashed[4].data[row]);
+        ASSERT_NEAR(hashed[2].data[row], single[2].data[row], 1e-9);
+        ASSERT_EQ(hashed[3].data[row], single[3].data[row]);
+        count += hashed[4].data[row];
+    }
+    ASSERT_EQ(count, 50000);
+}
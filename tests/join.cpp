@@ -0,0 +1,126 @@
+#include <csvd/join.hpp>
+
+#include <cmath>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+#include "fixtures.hpp"
+
+TEST(join, inner_and_left_join){
+    csvd::CSVd measurement;
+    measurement.push_back(make_column("Channel", {3, 1, 2, 5, 1}));
+    measurement.push_back(make_column("Value", {30, 10, 20, 50, 11}));
+
+    csvd::CSVd calibration;
+    calibration.push_back(make_column("Id", {1, 2, 3, 3}));
+    calibration.push_back(make_column("Value", {0.1, 0.2, 0.3, 0.33}));
+
+    const csvd::CSVd inner = csvd::inner_join(measurement, calibration, "Channel", "Id");
+    ASSERT_EQ(inner.size(), 3);
+    ASSERT_EQ(inner[0].name, "Channel");
+    ASSERT_EQ(inner[1].name, "Value_left");
+    ASSERT_EQ(inner[2].name, "Value_right");
+
+    // ordered by left row, then right row
+    const std::vector<double> channels{3, 3, 1, 2, 1};
+    const std::vector<double> offsets{0.3, 0.33, 0.1, 0.2, 0.1};
+    ASSERT_EQ(inner[0].data.size(), channels.size());
+    for(size_t i = 0; i < channels.size(); ++i){
+        ASSERT_EQ(inner[0].data[i], channels[i]);
+        ASSERT_EQ(inner[2].data[i], offsets[i]);
+    }
+
+    const csvd::CSVd left = csvd::left_join(measurement, calibration, "Channel", "Id");
+    ASSERT_EQ(left[0].data.size(), 6);
+    ASSERT_EQ(left[0].data[4], 5);
+    ASSERT_EQ(left[1].data[4], 50);
+    ASSERT_TRUE(std::isnan(left[2].data[4]));
+
+    ASSERT_THROW((void)csvd::inner_join(measurement, calibration, "Unknown", "Id"), std::out_of_range);
+}
+
+TEST(join, merge_and_hash_join_agree){
+    // sorted keys take the merge join, shuffled keys the hash join
+    const size_t rows = 5'000;
+    const csvd::Column sorted_key = make_column("Key", rows, [](size_t i){return static_cast<double>(i / 3);});
+    const csvd::Column shuffled_key = make_column("Key", rows, [&](size_t i){return static_cast<double>(((i * 7919) % rows) / 3);});
+    const csvd::Column row = make_column("Row", rows, [](size_t i){return static_cast<double>(i);});
+    csvd::CSVd right;
+    right.push_back(make_column("Key", rows / 2, [](size_t i){return static_cast<double>(2 * i / 3);}));
+    right.push_back(make_column("Payload", rows / 2, [](size_t i){return static_cast<double>(2 * i) * 0.5;}));
+
+    csvd::CSVd sorted;
+    sorted.push_back(sorted_key);
+    sorted.push_back(row);
+    csvd::CSVd shuffled;
+    shuffled.push_back(shuffled_key);
+    shuffled.push_back(row);
+
+    const csvd::ParallelSettings parallel{.threshold = 500, .max_threads = 4};
+    const csvd::CSVd merged = csvd::left_join(sorted, right, "Key", "Key", csvd::JoinSettings(), parallel);
+    const csvd::CSVd hashed = csvd::left_join(shuffled, right, "Key", "Key", csvd::JoinSettings(), parallel);
+    ASSERT_EQ(merged.size(), 3);
+    ASSERT_EQ(merged[2].name, "Payload");
+
+    // same multiset of (key, payload) pairs
+    const auto pairs = [](const csvd::CSVd& table){
+        std::vector<std::pair<double, double>> result;
+        for(size_t i = 0; i < table[0].data.size(); ++i){
+            result.emplace_back(table[0].data[i], std::isnan(table[2].data[i]) ? -1.0 : table[2].data[i]);
+        }
+        std::ranges::sort(result);
+        return result;
+    };
+    ASSERT_EQ(pairs(merged), pairs(hashed));
+
+    // hash join output is ordered by the left row
+    for(size_t i = 1; i < hashed[1].data.size(); ++i){
+        ASSERT_LE(hashed[1].data[i - 1], hashed[1].data[i]);
+    }
+}
+
+TEST(join, asof_join){
+    csvd::CSVd fast;
+    fast.push_back(make_column("Time", {0.0, 1.0, 2.0, 3.0, 4.0, 5.0}));
+    fast.push_back(make_column("Current", {0, 1, 2, 3, 4, 5}));
+
+    csvd::CSVd slow;
+    slow.push_back(make_column("Time", {0.5, 2.0, 4.5}));
+    slow.push_back(make_column("Temperature", {10, 20, 45}));
+
+    const auto temperatures = [&](csvd::AsofDirection direction, double tolerance){
+        csvd::AsofSettings settings;
+        settings.direction = direction;
+        settings.tolerance = tolerance;
+        const csvd::CSVd joined = csvd::asof_join(fast, slow, "Time", "Time", settings, csvd::ParallelSettings{.threshold = 2, .max_threads = 3});
+        EXPECT_EQ(joined.size(), 3);
+        EXPECT_EQ(joined[2].name, "Temperature");
+        EXPECT_EQ(joined[0].data.size(), 6);
+        return std::vector<double>(joined[2].data.begin(), joined[2].data.end());
+    };
+
+    const auto expect_values = [](const std::vector<double>& actual, const std::vector<double>& expected){
+        ASSERT_EQ(actual.size(), expected.size());
+        for(size_t i = 0; i < expected.size(); ++i){
+            if(std::isnan(expected[i])){
+                ASSERT_TRUE(std::isnan(actual[i])) << "row " << i;
+            }else{
+                ASSERT_DOUBLE_EQ(actual[i], expected[i]) << "row " << i;
+            }
+        }
+    };
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    expect_values(temperatures(csvd::AsofDirection::Backward, inf), {nan, 10, 20, 20, 20, 45});
+    expect_values(temperatures(csvd::AsofDirection::Forward, inf), {10, 20, 20, 45, 45, nan});
+    expect_values(temperatures(csvd::AsofDirection::Nearest, inf), {10, 10, 20, 20, 45, 45});
+    expect_values(temperatures(csvd::AsofDirection::Backward, 0.6), {nan, 10, 20, nan, nan, 45});
+    expect_values(temperatures(csvd::AsofDirection::Interpolate, inf), {nan, 10.0 + 10.0 / 3.0, 20, 30, 40, nan});
+
+    csvd::CSVd unsorted;
+    unsorted.push_back(make_column("Time", {1.0, 0.0}));
+    ASSERT_THROW((void)csvd::asof_join(unsorted, slow, "Time", "Time"), std::invalid_argument);
+}
@@ -0,0 +1,114 @@
+#include <csvd/query.hpp>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+#include "fixtures.hpp"
+
+using csvd::col;
+
+static std::string make_file(size_t rows){
+    return make_file("Index, Channel, Real, Imag, Unused", rows, [](std::ostream& file, size_t i){
+        file << i << ", " << (i % 3) << ", " << (static_cast<double>(i) * 0.5) << ", " << (static_cast<double>(i) * 0.25) << ", x";
+    });
+}
+
+TEST(query, collect_and_write){
+    // the unused column is not a number, it must never be converted
+    const size_t rows = 3000;
+    std::stringstream file(make_file(rows));
+    tl::expected<csvd::CSVd, csvd::ReadError> result = csvd::Query(file)
+        .derive("Magnitude", csvd::hypot(col("Real"), col("Imag")))
+        .filter(col("Channel") == 1.0)
+        .derive("Scaled", col("Magnitude") * 2.0)
+        .filter(col("Index") < 2000.0)
+        .select({"Index", "Scaled"})
+        .collect();
+    ASSERT_TRUE(result.has_value()) << result.error();
+    ASSERT_EQ(result->size(), 2);
+    ASSERT_EQ((*result)[1].name, "Scaled");
+
+    size_t row = 0;
+    for(size_t i = 0; i < 2000; ++i){
+        if(i % 3 != 1) continue;
+        ASSERT_EQ((*result)[0].data[row], static_cast<double>(i));
+        ASSERT_DOUBLE_EQ((*result)[1].data[row], 2.0 * std::hypot(static_cast<double>(i) * 0.5, static_cast<double>(i) * 0.25));
+        ++row;
+    }
+    ASSERT_EQ((*result)[0].data.size(), row);
+
+    std::stringstream small(
+        "Time, Voltage, Current\n"
+        "0, 1, 0.5\n"
+        "1, 2, 0.25\n"
+        "2, 3, 2\n");
+    std::stringstream out;
+    tl::expected<void, csvd::ReadError> written = csvd::Query(small)
+        .derive("Power", col("Voltage") * col("Current"))
+        .filter(col("Time") > 0.0)
+        .write(out);
+    ASSERT_TRUE(written.has_value()) << written.error();
+    ASSERT_EQ(out.str(),
+        "\"Time\",\"Voltage\",\"Current\",\"Power\"\n"
+        "1,2,0.25,0.5\n"
+        "2,3,2,6\n");
+}
+
+TEST(query, aggregate_and_errors){
+    std::stringstream file(make_file(3000));
+    tl::expected<csvd::CSVd, csvd::ReadError> result = csvd::Query(file)
+        .filter(col("Index") >= 3.0)
+        .aggregate({"Channel"}, {{"Real", csvd::Aggregate::Count}, {"Real", csvd::Aggregate::Max}});
+    ASSERT_TRUE(result.has_value()) << result.error();
+    ASSERT_EQ(result->size(), 3);
+    ASSERT_EQ((*result)[2].name, "Real_max");
+    ASSERT_EQ((*result)[0].data.size(), 3);
+    for(size_t channel = 0; channel < 3; ++channel){
+        ASSERT_EQ((*result)[0].data[channel], static_cast<double>(channel));
+        ASSERT_EQ((*result)[1].data[channel], 999);
+        ASSERT_EQ((*result)[2].data[channel], (2997.0 + static_cast<double>(channel)) * 0.5);
+    }
+
+    // derived columns are only visible to later steps
+    std::stringstream unknown_file(make_file(10));
+    tl::expected<csvd::CSVd, csvd::ReadError> unknown = csvd::Query(unknown_file)
+        .filter(col("Magnitude") > 1.0)
+        .derive("Magnitude", col("Real"))
+        .collect();
+    ASSERT_FALSE(unknown.has_value());
+    ASSERT_EQ(unknown.error().error_case(), csvd::ErrorCase::UnknownColumn);
+
+    // selected columns are converted
+    std::stringstream bad_file(make_file(10));
+    tl::expected<csvd::CSVd, csvd::ReadError> bad = csvd::Query(bad_file).select({"Unused"}).collect();
+    ASSERT_FALSE(bad.has_value());
+    ASSERT_EQ(bad.error().error_case(), csvd::ErrorCase::ErrorParsingFloat);
+}
+
+TEST(query, find_first_row){
+    std::stringstream file;
+    file << "Time, Real, Imag\n";
+    for(size_t i = 0; i < 5000; ++i){
+        file << (static_cast<double>(i) * 0.01) << ", " << static_cast<double>(i) << ", " << (static_cast<double>(i) * 0.5) << "\n";
+    }
+    file << "this row is never parsed\n";
+
+    tl::expected<std::optional<csvd::FoundRow>, csvd::ReadError> found = csvd::find_first_row(file, csvd::hypot(col("Real"), col("Imag")) > 1000.0);
+    ASSERT_TRUE(found.has_value()) << found.error();
+    ASSERT_TRUE(found->has_value());
+    // hypot(i, i/2) = i * 1.118..., the first i above 1000 is 895, in line 896 behind the header
+    ASSERT_EQ((*found)->row, 896);
+    ASSERT_EQ((*found)->values.size(), 3);
+    ASSERT_DOUBLE_EQ((*found)->values[0], 8.95);
+    ASSERT_EQ((*found)->values[1], 895.0);
+    ASSERT_EQ((*found)->values[2], 447.5);
+
+    std::stringstream small("Time, Value\n1, 2\n3, 4\n");
+    tl::expected<std::optional<csvd::FoundRow>, csvd::ReadError> none = csvd::find_first_row(small, col("Value") > 10.0);
+    ASSERT_TRUE(none.has_value());
+    ASSERT_FALSE(none->has_value());
+}
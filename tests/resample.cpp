@@ -0,0 +1,81 @@
+#include <csvd/resample.hpp>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+static void expect_values(const std::deque<double>& actual, const std::vector<double>& expected){
+    ASSERT_EQ(actual.size(), expected.size());
+    for(size_t i = 0; i < expected.size(); ++i){
+        if(std::isnan(expected[i])){
+            ASSERT_TRUE(std::isnan(actual[i])) << "row " << i;
+        }else{
+            ASSERT_DOUBLE_EQ(actual[i], expected[i]) << "row " << i;
+        }
+    }
+}
+
+TEST(resample, interpolations){
+    csvd::CSVd csv;
+    csv.push_back(csvd::Column());
+    csv.push_back(csvd::Column());
+    csv[0].name = "Time";
+    csv[1].name = "Value";
+    for(const double time : {1.0, 2.0, 4.0}){
+        csv[0].push_back(time);
+        csv[1].push_back(time * 10);
+    }
+
+    const std::vector<double> grid = csvd::uniform_grid(0.5, 4.5, 9);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    const csvd::CSVd linear = csvd::resample(csv, "Time", grid, csvd::Interpolation::Linear);
+    expect_values(linear[0].data, grid);
+    expect_values(linear[1].data, {nan, 10, 15, 20, 25, 30, 35, 40, nan});
+
+    const csvd::CSVd nearest = csvd::resample(csv, "Time", grid, csvd::Interpolation::Nearest);
+    expect_values(nearest[1].data, {nan, 10, 10, 20, 20, 20, 40, 40, nan});
+
+    const csvd::CSVd hold = csvd::resample(csv, "Time", grid, csvd::Interpolation::ZeroOrderHold);
+    expect_values(hold[1].data, {nan, 10, 10, 20, 20, 20, 20, 40, nan});
+
+    const csvd::CSVd decimated = csvd::decimate(csv, 2);
+    expect_values(decimated[0].data, {1.5, 4});
+    expect_values(decimated[1].data, {15, 40});
+
+    const std::vector<double> log_grid = csvd::logarithmic_grid(0.1, 1000, 5);
+    ASSERT_EQ(log_grid.size(), 5);
+    ASSERT_DOUBLE_EQ(log_grid[0], 0.1);
+    ASSERT_DOUBLE_EQ(log_grid[2], 10);
+    ASSERT_DOUBLE_EQ(log_grid[4], 1000);
+
+    ASSERT_THROW((void)csvd::resample(csv, "Missing", grid), std::out_of_range);
+    ASSERT_THROW((void)csvd::resample(csv, "Value", {2.0, 1.0}), std::invalid_argument);
+}
+
+TEST(resample, from_reader){
+    const std::string text = "Time, Value\n1, 10\n2, 20\n4, 40\n";
+
+    std::stringstream file(text);
+    csvd::Reader reader(file);
+    const tl::expected<csvd::CSVd, csvd::ReadError> resampled = csvd::resample(reader, "Time", csvd::uniform_grid(1, 4, 4));
+    ASSERT_TRUE(resampled.has_value()) << resampled.error();
+    ASSERT_EQ(resampled->size(), 2);
+    ASSERT_EQ((*resampled)[1].name, "Value");
+    expect_values((*resampled)[1].data, {10, 20, 30, 40});
+
+    std::stringstream decimate_file(text);
+    csvd::Reader decimate_reader(decimate_file);
+    const tl::expected<csvd::CSVd, csvd::ReadError> decimated = csvd::decimate(decimate_reader, 3);
+    ASSERT_TRUE(decimated.has_value()) << decimated.error();
+    expect_values((*decimated)[1].data, {70.0 / 3.0});
+
+    std::stringstream unknown_file(text);
+    csvd::Reader unknown_reader(unknown_file);
+    const tl::expected<csvd::CSVd, csvd::ReadError> unknown = csvd::resample(unknown_reader, "Frequency", {1.0});
+    ASSERT_FALSE(unknown.has_value());
+    ASSERT_EQ(unknown.error().error_case(), csvd::ErrorCase::UnknownColumn);
+}
@@ -0,0 +1,58 @@
+#include <csvd/rewrite.hpp>
+
+#include <sstream>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+TEST(rewrite, select_and_reorder){
+    std::stringstream input(
+        "Time; Voltage; Label\n"
+        "0.1;  1.000000000000000001 ; 'a,b'\n"
+        "\n"
+        "0.2; 1e-3; x,y\n");
+    std::stringstream output;
+    csvd::Settings semicolons;
+    semicolons.value_separators = {';', '\0'};
+    csvd::Settings commas;
+    commas.value_separators = {',', '\0'};
+
+    // cells are copied exactly, without a round trip through double
+    tl::expected<void, csvd::ReadError> result = csvd::rewrite(input, output, {"Label", "Voltage"}, semicolons, commas);
+    ASSERT_TRUE(result.has_value()) << result.error();
+    ASSERT_EQ(output.str(),
+        "\"Label\",\"Voltage\"\n"
+        "'a,b',1.000000000000000001\n"
+        "\"x,y\",1e-3\n");
+
+    std::stringstream all_input("A, B\n1, 2\n");
+    std::stringstream all_output;
+    ASSERT_TRUE(csvd::rewrite(all_input, all_output, {}).has_value());
+    ASSERT_EQ(all_output.str(), "\"A\",\"B\"\n1,2\n");
+}
+
+TEST(rewrite, errors){
+    std::stringstream input("A, B\n1, 2\n");
+    std::stringstream output;
+    tl::expected<void, csvd::ReadError> unknown = csvd::rewrite(input, output, {"C"});
+    ASSERT_FALSE(unknown.has_value());
+    ASSERT_EQ(unknown.error().error_case(), csvd::ErrorCase::UnknownColumn);
+
+    // the shape of the rows is still checked
+    std::stringstream short_input("A, B\n1, 2\n3\n");
+    tl::expected<void, csvd::ReadError> short_row = csvd::rewrite(short_input, output, {"B"});
+    ASSERT_FALSE(short_row.has_value());
+    ASSERT_EQ(short_row.error().error_case(), csvd::ErrorCase::UnexpectedLineSeparator);
+}
+
+TEST(rewrite, fill_nan){
+    // the cells of a short row are not taken from the row before
+    std::stringstream input("a,b,c\n1,2,3\n4,5\n7,8,9\n");
+    std::stringstream output;
+    csvd::Settings settings;
+    settings.bad_rows = csvd::BadRows::FillNaN;
+    tl::expected<void, csvd::ReadError> result = csvd::rewrite(input, output, {}, settings);
+    ASSERT_TRUE(result.has_value()) << result.error();
+    ASSERT_EQ(output.str(), "\"a\",\"b\",\"c\"\n1,2,3\nnan,nan,nan\n7,8,9\n");
+}
@@ -0,0 +1,124 @@
+#include <csvd/search.hpp>
+#include <csvd/sort.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <sstream>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+TEST(search, sortedness){
+    csvd::Column column;
+    ASSERT_EQ(column.sortedness, csvd::Sortedness::Constant);
+    column.push_back(1);
+    column.push_back(1);
+    ASSERT_EQ(column.sortedness, csvd::Sortedness::Constant);
+    column.push_back(2);
+    ASSERT_EQ(column.sortedness, csvd::Sortedness::Ascending);
+    column.push_back(0);
+    ASSERT_EQ(column.sortedness, csvd::Sortedness::Unsorted);
+
+    csvd::Column descending;
+    for(const double value : {3.0, 2.0, 2.0, -1.0}) descending.push_back(value);
+    ASSERT_EQ(descending.sortedness, csvd::Sortedness::Descending);
+    descending.push_back(NAN);
+    ASSERT_EQ(descending.sortedness, csvd::Sortedness::Unsorted);
+
+    // flagged by the parser, kept up to date by sorting
+    std::stringstream file(
+        "Time, Value\n"
+        "0.1, 5\n"
+        "0.2, 3\n"
+        "0.3, 4\n");
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(file);
+    ASSERT_TRUE(csv.has_value());
+    ASSERT_EQ(csv.value()[0].sortedness, csvd::Sortedness::Ascending);
+    ASSERT_EQ(csv.value()[1].sortedness, csvd::Sortedness::Unsorted);
+    csvd::sort_by(csv.value(), {"Value"});
+    ASSERT_EQ(csv.value()[0].sortedness, csvd::Sortedness::Unsorted);
+    ASSERT_EQ(csv.value()[1].sortedness, csvd::Sortedness::Ascending);
+
+    // values written directly are not covered by the tracked order
+    csvd::CSVd direct;
+    direct.push_back(csvd::Column());
+    direct[0].values() = {5, 1, 3};
+    ASSERT_FALSE(direct[0].has_sortedness());
+    ASSERT_EQ(direct[0].order(), csvd::Sortedness::Unsorted);
+    ASSERT_THROW((void)csvd::lower_bound(direct[0], 3.0), std::invalid_argument);
+    direct[0].values() = {1, 2, 4};
+    ASSERT_EQ(csvd::lower_bound(direct[0], 3.0), 2);
+    direct[0].update_sortedness();
+    ASSERT_TRUE(direct[0].has_sortedness());
+    ASSERT_EQ(direct[0].sortedness, csvd::Sortedness::Ascending);
+
+    // in place modifications that keep the size also invalidate the order
+    direct[0].values()[1] = 100;
+    ASSERT_FALSE(direct[0].has_sortedness());
+    ASSERT_EQ(direct[0].order(), csvd::Sortedness::Unsorted);
+    ASSERT_THROW((void)csvd::lower_bound(direct[0], 3.0), std::invalid_argument);
+    std::ranges::sort(direct[0].values(), std::greater<>());
+    ASSERT_EQ(direct[0].order(), csvd::Sortedness::Descending);
+    direct[0].update_sortedness();
+    ASSERT_EQ(direct[0].sortedness, csvd::Sortedness::Descending);
+
+    // appending to directly written values brings the order and the zones up to date
+    direct.push_back({"New Column", {5, 1, 3}});
+    direct[1].push_back(4);
+    ASSERT_TRUE(direct[1].has_sortedness());
+    ASSERT_EQ(direct[1].sortedness, csvd::Sortedness::Unsorted);
+    ASSERT_TRUE(direct[1].has_zones());
+    ASSERT_EQ(direct[1].zones[0].min, 1.0);
+    ASSERT_EQ(direct[1].zones[0].max, 5.0);
+}
+
+TEST(search, range_queries){
+    csvd::CSVd csv;
+    csv.push_back(csvd::Column());
+    csv.push_back(csvd::Column());
+    csv[0].name = "Time";
+    csv[1].name = "Voltage";
+    for(const double time : {0.0, 1.0, 2.0, 2.0, 2.0, 3.0, 5.0}){
+        csv[0].push_back(time);
+        csv[1].push_back(time * 10);
+    }
+
+    ASSERT_EQ(csvd::lower_bound(csv[0], 2.0), 2);
+    ASSERT_EQ(csvd::upper_bound(csv[0], 2.0), 5);
+    ASSERT_EQ(csvd::lower_bound(csv[0], 4.0), 6);
+    const csvd::RowRange equal = csvd::equal_range(csv[0], 2.0);
+    ASSERT_EQ(equal.first, 2);
+    ASSERT_EQ(equal.last, 5);
+    ASSERT_TRUE(csvd::equal_range(csv[0], 4.0).empty());
+
+    const csvd::RowRange window = csvd::find_range(csv[0], 0.5, 3.0);
+    ASSERT_EQ(window.first, 1);
+    ASSERT_EQ(window.size(), 5);
+    const csvd::ColumnSlice voltages = csvd::slice(csv[1], window);
+    ASSERT_EQ(voltages.size(), 5);
+    ASSERT_EQ(voltages.front(), 10);
+    ASSERT_EQ(voltages.back(), 30);
+    ASSERT_EQ(&voltages.front(), &csv[1].data[1]); // no copy
+
+    csvd::Column descending;
+    for(const double value : {5.0, 4.0, 3.0, 2.0, 1.0}) descending.push_back(value);
+    const csvd::RowRange descending_window = csvd::find_range(descending, 1.5, 4.0);
+    ASSERT_EQ(descending_window.first, 1);
+    ASSERT_EQ(descending_window.last, 4);
+    ASSERT_EQ(csvd::lower_bound(descending, 3.5), 2);
+
+    // long columns are bisected over their zones first
+    csvd::Column long_column;
+    for(size_t i = 0; i < 3 * csvd::zone_size + 5; ++i) long_column.push_back(static_cast<double>(i / 2));
+    for(const double value : {-1.0, 0.0, 2047.5, 2048.0, 4095.0, 6000.0, 6146.0, 1e9}){
+        const auto expected = std::ranges::equal_range(long_column.data, value);
+        const csvd::RowRange range = csvd::equal_range(long_column, value);
+        ASSERT_EQ(range.first, static_cast<size_t>(expected.begin() - long_column.data.begin())) << value;
+        ASSERT_EQ(range.last, static_cast<size_t>(expected.end() - long_column.data.begin())) << value;
+    }
+
+    csv[1].push_back(0.0);
+    ASSERT_THROW((void)csvd::lower_bound(csv[1], 1.0), std::invalid_argument);
+}
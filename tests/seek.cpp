@@ -0,0 +1,80 @@
+#include <csvd/seek.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// google test
+#include <gtest/gtest.h>
+
+/**
+ * @brief Writes a log with `rows` rows and returns its path and the byte offset of every row
+ */
+static std::filesystem::path write_log(const std::string& file_name, size_t rows, bool header, std::vector<std::uint64_t>& offsets){
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / file_name;
+    std::ofstream file(path, std::ios::binary);
+    if(header){
+        file << "\"Time\"; Value\n";
+    }
+    for(size_t i = 0; i < rows; ++i){
+        if(i % 1000 == 500){
+            file << "\n"; // blank lines are skipped
+        }
+        offsets.push_back(static_cast<std::uint64_t>(file.tellp()));
+        file << static_cast<double>(i / 2) * 0.5 << "; " << static_cast<double>(i) << "\n";
+    }
+    return path;
+}
+
+TEST(seek, seek_value){
+    std::vector<std::uint64_t> offsets;
+    const std::filesystem::path path = write_log("csvd_seek_value.csv", 10'001, true, offsets);
+    const std::uint64_t size = std::filesystem::file_size(path);
+
+    ASSERT_EQ(csvd::seek_value(path, "Time", -1.0).value(), offsets[0]);
+    ASSERT_EQ(csvd::seek_value(path, "Time", 0.0).value(), offsets[0]);
+    ASSERT_EQ(csvd::seek_value(path, "Time", 0.1).value(), offsets[2]);
+    ASSERT_EQ(csvd::seek_value(path, "Time", 1250.0).value(), offsets[5'000]);
+    ASSERT_EQ(csvd::seek_value(path, "Time", 1250.25).value(), offsets[5'002]);
+    ASSERT_EQ(csvd::seek_value(path, "Time", 2500.0).value(), offsets[10'000]);
+    ASSERT_EQ(csvd::seek_value(path, "Time", 3000.0).value(), size);
+    ASSERT_EQ(csvd::seek_value(path, "Value", 777.0).value(), offsets[777]);
+
+    const auto unknown = csvd::seek_value(path, "Voltage", 1.0);
+    ASSERT_FALSE(unknown.has_value());
+    ASSERT_EQ(unknown.error().error_case(), csvd::ErrorCase::UnknownColumn);
+    ASSERT_FALSE(csvd::seek_value(std::filesystem::temp_directory_path() / "csvd_missing.csv", "Time", 1.0).has_value());
+    std::filesystem::remove(path);
+}
+
+TEST(seek, read_range){
+    std::vector<std::uint64_t> offsets;
+    const std::filesystem::path path = write_log("csvd_read_range.csv", 3'000, true, offsets);
+
+    tl::expected<csvd::CSVd, csvd::ReadError> window = csvd::read_range(path, "Time", 100.0, 200.0);
+    ASSERT_TRUE(window.has_value()) << window.error();
+    ASSERT_EQ(window->size(), 2);
+    ASSERT_EQ((*window)[0].name, "Time");
+    ASSERT_EQ((*window)[1].name, "Value");
+    ASSERT_EQ((*window)[0].data.size(), 402);
+    ASSERT_EQ((*window)[0].data.front(), 100.0);
+    ASSERT_EQ((*window)[0].data.back(), 200.0);
+    ASSERT_EQ((*window)[1].data.front(), 400.0);
+
+    csvd::Settings settings;
+    settings.row_predicates.push_back(csvd::RowPredicate{.column = "Value", .min = 450.0, .max = 459.0});
+    tl::expected<csvd::CSVd, csvd::ReadError> filtered = csvd::read_range(path, "Time", 100.0, 200.0, settings);
+    ASSERT_TRUE(filtered.has_value()) << filtered.error();
+    ASSERT_EQ((*filtered)[1].data.size(), 10);
+    std::filesystem::remove(path);
+
+    // without a header the column is selected by index
+    offsets.clear();
+    const std::filesystem::path headerless = write_log("csvd_read_range_headerless.csv", 100, false, offsets);
+    ASSERT_EQ(csvd::seek_value(headerless, size_t(0), 10.0).value(), offsets[40]);
+    tl::expected<csvd::CSVd, csvd::ReadError> tail = csvd::read_range(headerless, size_t(0), 24.0, 1e9);
+    ASSERT_TRUE(tail.has_value()) << tail.error();
+    ASSERT_EQ((*tail)[1].data.size(), 4);
+    ASSERT_EQ((*tail)[1].data.back(), 99.0);
+    std::filesystem::remove(headerless);
+}
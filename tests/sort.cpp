@@ -0,0 +1,82 @@
+#include <csvd/sort.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+// google test
+#include <gtest/gtest.h>
+
+#include "fixtures.hpp"
+
+static void expect_sorted(size_t rows, const csvd::ParallelSettings& parallel){
+    csvd::CSVd table;
+    table.push_back(make_column("Group", rows, [](size_t i){return static_cast<double>((i * 7) % 5) - 2.0;}));
+    table.push_back(make_column("Value", rows, [](size_t i){return std::sin(static_cast<double>(i)) * 100.0;}));
+    table.push_back(make_column("Index", rows, [](size_t i){return static_cast<double>(i);}));
+    const csvd::CSVd original = table;
+
+    csvd::sort_by(table, {"Group", "Value"}, {csvd::Order::Descending, csvd::Order::Ascending}, parallel);
+
+    // reference
+    std::vector<size_t> expected(rows);
+    std::iota(expected.begin(), expected.end(), size_t(0));
+    std::ranges::stable_sort(expected, [&](size_t a, size_t b){
+        const double group_a = original[0].data[a];
+        const double group_b = original[0].data[b];
+        if(group_a != group_b) return group_a > group_b;
+        return original[1].data[a] < original[1].data[b];
+    });
+
+    for(size_t i = 0; i < rows; ++i){
+        ASSERT_EQ(table[2].data[i], static_cast<double>(expected[i]));
+        ASSERT_EQ(table[0].data[i], original[0].data[expected[i]]);
+        ASSERT_EQ(table[1].data[i], original[1].data[expected[i]]);
+    }
+}
+
+TEST(sort, small_table){
+    expect_sorted(100, csvd::ParallelSettings());
+}
+
+TEST(sort, large_table_radix){
+    expect_sorted(20'000, csvd::ParallelSettings{.threshold = 3'000, .max_threads = 3});
+}
+
+TEST(sort, signed_zero_ties){
+    // -0.0 and 0.0 are equal keys, so the secondary column decides on the comparison and on the radix path
+    for(const size_t rows : {size_t(100), size_t(10'000)}){
+        csvd::CSVd table;
+        table.push_back(make_column("Key", rows, [](size_t i){return (i % 3 == 0) ? -0.0 : (i % 3 == 1) ? 0.0 : 1.0;}));
+        table.push_back(make_column("Value", rows, [](size_t i){return std::sin(static_cast<double>(i));}));
+
+        csvd::sort_by(table, {"Key", "Value"}, {}, csvd::ParallelSettings{.threshold = 3'000, .max_threads = 3});
+
+        for(size_t i = 1; i < rows; ++i){
+            ASSERT_LE(table[0].data[i - 1], table[0].data[i]) << "rows " << rows << ", row " << i;
+            if(table[0].data[i - 1] == table[0].data[i]){
+                ASSERT_LE(table[1].data[i - 1], table[1].data[i]) << "rows " << rows << ", row " << i;
+            }
+        }
+    }
+}
+
+TEST(sort, negative_zero_and_stability){
+    csvd::CSVd table;
+    csvd::Column key;
+    key.name = "Key";
+    csvd::Column index;
+    index.name = "Index";
+    const std::vector<double> keys{3.0, -1.0, 3.0, -0.5, 1e300, -1e300, 3.0};
+    for(size_t i = 0; i < keys.size(); ++i){
+        key.push_back(keys[i]);
+        index.push_back(static_cast<double>(i));
+    }
+    table.push_back(std::move(key));
+    table.push_back(std::move(index));
+
+    const std::vector<size_t> permutation = csvd::sort_permutation(table, {"Key"});
+    ASSERT_EQ(permutation, (std::vector<size_t>{5, 1, 3, 0, 2, 6, 4}));
+
+    ASSERT_THROW(csvd::sort_by(table, {"Unknown"}), std::out_of_range);
+}
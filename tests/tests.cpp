@@ -2,6 +2,8 @@
 
 #include <sstream>
 #include <ranges>
+#include <algorithm>
+#include <cmath>
 
 // google test
 #include <gtest/gtest.h>
@@ -34,3 +36,293 @@ TEST(csvd, read_correct_file){
     ASSERT_NEAR(col.data.front(), 0.0159155, 0.00001);
     ASSERT_NEAR(col.data.back(), 0.0170657, 0.00001);
 }
+
+TEST(csvd, read_with_statistics){
+    std::stringstream file;
+    file << 
+    "Time, Value\n"
+    "1, 0.5\n"
+    "2, -1.5\n"
+    "3, 4.0\n"
+    "4, 2.0\n";
+
+    csvd::Settings settings;
+    settings.compute_statistics = true;
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(file, settings);
+    ASSERT_TRUE(csv.has_value());
+    ASSERT_EQ(csv.value().size(), 2);
+
+    for(const csvd::Column& column : csv.value()){
+        ASSERT_TRUE(column.statistics.has_value());
+
+        // compare against a separate two pass computation
+        double sum = 0;
+        for(double value : column.data) sum += value;
+        const double mean = sum / column.data.size();
+        double squares = 0;
+        for(double value : column.data) squares += (value - mean) * (value - mean);
+
+        const csvd::Statistics& stats = column.statistics.value();
+        ASSERT_EQ(stats.count, column.data.size());
+        ASSERT_DOUBLE_EQ(stats.min, *std::ranges::min_element(column.data));
+        ASSERT_DOUBLE_EQ(stats.max, *std::ranges::max_element(column.data));
+        ASSERT_NEAR(stats.mean, mean, 1e-12);
+        ASSERT_NEAR(stats.variance(), squares / column.data.size(), 1e-12);
+    }
+
+    // statistics stay valid when appending
+    csvd::Column& value = csv.value()[1];
+    value.push_back(10.0);
+    ASSERT_EQ(value.statistics->count, 5);
+    ASSERT_DOUBLE_EQ(value.statistics->max, 10.0);
+    ASSERT_NEAR(value.statistics->mean, 3.0, 1e-12);
+}
+
+TEST(csvd, statistics_merge){
+    csvd::Statistics all, first, second;
+    for(int i = 0; i < 100; ++i){
+        const double value = std::sin(i) * i;
+        all.push(value);
+        (i < 37 ? first : second).push(value);
+    }
+    first.merge(second);
+    ASSERT_EQ(first.count, all.count);
+    ASSERT_DOUBLE_EQ(first.min, all.min);
+    ASSERT_DOUBLE_EQ(first.max, all.max);
+    ASSERT_NEAR(first.mean, all.mean, 1e-9);
+    ASSERT_NEAR(first.variance(), all.variance(), 1e-9);
+}
+
+TEST(csvd, read_with_row_predicates){
+    std::stringstream file;
+    file << 
+    "Time, Value, Other\n"
+    "1, 0.5, 1\n"
+    "2, -1.5, 2\n"
+    "3, 4.0, 3\n"
+    "4, Error, 4\n" // never converted, because the row is dropped
+    "5, 2.0, 5\n";
+
+    csvd::Settings settings;
+    settings.compute_statistics = true;
+    csvd::RowPredicate time_window;
+    time_window.column = "Time";
+    time_window.min = 2;
+    time_window.max = 3;
+    settings.row_predicates.push_back(time_window);
+
+    csvd::RowPredicate other;
+    other.column = "Other";
+    other.max = 4.5;
+    settings.row_predicates.push_back(other);
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(file, settings);
+    ASSERT_TRUE(csv.has_value());
+
+    const csvd::Column& time = csv.value()[0];
+    ASSERT_EQ(time.data.size(), 2);
+    ASSERT_EQ(time.data[0], 2);
+    ASSERT_EQ(time.data[1], 3);
+    ASSERT_EQ(csv.value()[1].data[1], 4.0);
+    ASSERT_EQ(time.statistics->count, 2);
+}
+
+TEST(csvd, read_with_row_predicate_errors){
+    std::stringstream file;
+    file << 
+    "Time, Value\n"
+    "1, 0.5\n";
+
+    csvd::Settings settings;
+    csvd::RowPredicate unknown;
+    unknown.column = "Frequency";
+    settings.row_predicates.push_back(unknown);
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(file, settings);
+    ASSERT_FALSE(csv.has_value());
+    ASSERT_EQ(csv.error().error_case(), csvd::ErrorCase::UnknownColumn);
+    ASSERT_EQ(csv.error().cell(), "Frequency");
+
+    // predicates by index for files without header, the first row is filtered too
+    std::stringstream headerless;
+    headerless << 
+    "1, 0.5\n"
+    "2, 0.7\n";
+    csvd::RowPredicate by_index;
+    by_index.index = 1;
+    by_index.min = 0.6;
+    settings.row_predicates = {by_index};
+    csv = csvd::read(headerless, settings);
+    ASSERT_TRUE(csv.has_value());
+    ASSERT_EQ(csv.value().size(), 2);
+    ASSERT_EQ(csv.value()[0].data.size(), 1);
+    ASSERT_EQ(csv.value()[0].data[0], 2);
+}
+
+TEST(csvd, read_large_file){
+    // lines span over multiple internal read blocks
+    std::stringstream file;
+    file << "Index; Square\r\n";
+    const size_t rows = 50'000;
+    for(size_t i = 0; i < rows; ++i){
+        file << i << "; " << (i * i) << "\r\n";
+    }
+
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(file);
+    ASSERT_TRUE(csv.has_value());
+    ASSERT_EQ(csv.value()[1].name, "Square");
+    ASSERT_EQ(csv.value()[0].data.size(), rows);
+    for(size_t i = 0; i < rows; ++i){
+        ASSERT_EQ(csv.value()[1].data[i], static_cast<double>(i * i));
+    }
+}
+
+TEST(csvd, write_matches_stream_formatting){
+    csvd::CSVd csv;
+    csv.push_back(csvd::Column());
+    csv.push_back(csvd::Column());
+    csv[0].name = "Value";
+    const std::vector<double> values{0.0, -0.0, 1.0, -2.5, 1.0 / 3.0, 123456789.0, 1e-300, 6.02214076e23, 1e300,
+        std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+    csv[0].append(values.begin(), values.end());
+    csv[1].append(values.rbegin(), values.rend());
+
+    const auto expected_output = [&](std::ostream& format){
+        std::stringstream expected;
+        expected.copyfmt(format);
+        expected << "\"Value\",\"1\"\n";
+        for(size_t i = 0; i < values.size(); ++i){
+            expected << values[i] << ',' << values[values.size() - 1 - i] << '\n';
+        }
+        return expected.str();
+    };
+
+    for(const int precision : {6, 2, 17}){
+        for(const std::ios_base::fmtflags floatfield : {std::ios_base::fmtflags{}, std::ios_base::fixed, std::ios_base::scientific, std::ios_base::fixed | std::ios_base::scientific}){
+            std::stringstream out;
+            out.precision(precision);
+            out.setf(floatfield, std::ios_base::floatfield);
+            csv.write(out);
+            ASSERT_EQ(out.str(), expected_output(out)) << "precision " << precision;
+        }
+    }
+}
+
+TEST(csvd, read_stats){
+    std::stringstream file;
+    file << "Time, Value\n";
+    for(size_t i = 0; i < 10'000; ++i){
+        file << i << ", " << (i * 2) << "\n";
+    }
+    const size_t bytes = file.str().size();
+
+    csvd::ReadStats stats;
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(file, csvd::Settings(), &stats);
+    ASSERT_TRUE(csv.has_value());
+    if(stats.recorded){
+        ASSERT_EQ(stats.bytes, bytes);
+        ASSERT_EQ(stats.rows, 10'000);
+        ASSERT_EQ(stats.cells, 20'000);
+        ASSERT_GT(stats.allocations, 2);
+        ASSERT_GE(stats.memory, 20'000 * sizeof(double));
+        ASSERT_GT(stats.scan.count() + stats.convert.count() + stats.append.count(), 0);
+    }else{
+        // compiled out
+        ASSERT_EQ(stats.bytes, 0);
+        ASSERT_EQ(stats.rows, 0);
+        ASSERT_EQ(stats.allocations, 0);
+    }
+}
+
+TEST(csvd, read_progress_and_cancel){
+    std::stringstream file;
+    file << "Time, Value\n";
+    for(size_t i = 0; i < 50'000; ++i){
+        file << i << ", " << (i * 2) << "\n";
+    }
+    const size_t bytes = file.str().size();
+
+    std::vector<csvd::ReadProgress> reports;
+    csvd::ReadControl control;
+    control.progress = [&](const csvd::ReadProgress& progress){reports.push_back(progress);};
+    control.bytes_interval = size_t(1) << 17;
+    tl::expected<csvd::CSVd, csvd::ReadError> csv = csvd::read(file, csvd::Settings(), control);
+    ASSERT_TRUE(csv.has_value()) << csv.error();
+    ASSERT_GE(reports.size(), bytes / control.bytes_interval);
+    ASSERT_EQ(reports.back().bytes, bytes);
+    ASSERT_EQ(reports.back().total, bytes);
+    ASSERT_EQ(reports.back().rows, 50'000);
+    ASSERT_TRUE(std::ranges::is_sorted(reports, {}, &csvd::ReadProgress::bytes));
+
+    // a stop that is requested from the progress callback cancels the read within the next block
+    std::stringstream cancelled_file(file.str());
+    std::stop_source stop_source;
+    csvd::ReadControl cancel;
+    cancel.stop_token = stop_source.get_token();
+    cancel.rows_interval = 1000;
+    cancel.bytes_interval = 0;
+    cancel.progress = [&](const csvd::ReadProgress& progress){
+        if(progress.rows >= 5000) stop_source.request_stop();
+    };
+    csvd::CSVd partial;
+    tl::expected<void, csvd::ReadError> result = partial.read(cancelled_file, cancel);
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(result.error().error_case(), csvd::ErrorCase::Cancelled);
+    ASSERT_EQ(partial[0].data.size(), 5'999);
+}
+
+TEST(csvd, read_bad_rows){
+    std::string text = "Time, Value\n";
+    std::vector<size_t> bad_offsets;
+    for(size_t i = 0; i < 30'000; ++i){
+        if(i % 10'000 == 5){
+            bad_offsets.push_back(text.size());
+            text += (i == 5) ? "5, abc\n" : (i == 10'005) ? "10005, 1, 2\n" : "20005\n";
+        }else{
+            text += std::to_string(i) + ", " + std::to_string(i * 2) + "\n";
+        }
+    }
+
+    csvd::Settings settings;
+    {
+        std::istringstream file(text);
+        ASSERT_FALSE(csvd::read(file, settings).has_value());
+    }
+
+    settings.bad_rows = csvd::BadRows::Skip;
+    std::istringstream skipped_file(text);
+    tl::expected<csvd::CSVd, csvd::ReadError> skipped = csvd::read(skipped_file, settings);
+    ASSERT_TRUE(skipped.has_value()) << skipped.error();
+    ASSERT_EQ((*skipped)[0].data.size(), 30'000 - 3);
+    ASSERT_EQ((*skipped)[0].data[5], 6.0);
+    ASSERT_EQ(skipped->errors().size(), 3);
+    ASSERT_EQ(skipped->errors()[0].error_case(), csvd::ErrorCase::ErrorParsingFloat);
+    ASSERT_EQ(skipped->errors()[1].error_case(), csvd::ErrorCase::ExpectedLineSeparator);
+    ASSERT_EQ(skipped->errors()[2].error_case(), csvd::ErrorCase::UnexpectedLineSeparator);
+    for(size_t i = 0; i < bad_offsets.size(); ++i){
+        ASSERT_EQ(skipped->errors()[i].row(), 10'000 * i + 6);
+        ASSERT_EQ(skipped->errors()[i].line_offset(), bad_offsets[i]);
+    }
+
+    settings.bad_rows = csvd::BadRows::FillNaN;
+    std::istringstream filled_file(text);
+    tl::expected<csvd::CSVd, csvd::ReadError> filled = csvd::read(filled_file, settings);
+    ASSERT_TRUE(filled.has_value()) << filled.error();
+    ASSERT_EQ((*filled)[0].data.size(), 30'000);
+    ASSERT_TRUE(std::isnan((*filled)[0].data[5]));
+    ASSERT_TRUE(std::isnan((*filled)[1].data[10'005]));
+    ASSERT_EQ((*filled)[1].data[10'006], 20'012.0);
+
+    // the errors belong to the data of the table
+    csvd::CSVd other;
+    other.swap(*filled);
+    ASSERT_TRUE(filled->errors().empty());
+    ASSERT_EQ(other.errors().size(), 3);
+    other.clear();
+    ASSERT_TRUE(other.errors().empty());
+
+    // the read fails once there are more bad rows than allowed
+    settings.max_errors = 2;
+    std::istringstream limited_file(text);
+    tl::expected<csvd::CSVd, csvd::ReadError> limited = csvd::read(limited_file, settings);
+    ASSERT_FALSE(limited.has_value());
+    ASSERT_EQ(limited.error().line_offset(), bad_offsets[2]);
+}